@@ -0,0 +1,34 @@
+#include <snes.h>
+
+#include "arena.h"
+
+u16 g_arenaUsed;
+u8 g_arenaTag = ARENA_TAG_BOOT;
+u16 g_arenaPeak[SCENE_COUNT + 1];
+
+static u8 s_arena[ARENA_BYTES];
+
+void arena_reset(u8 scene) {
+    g_arenaUsed = 0;
+    g_arenaTag = scene;
+}
+
+void* arena_alloc(u16 bytes) {
+    u8* p;
+
+    bytes = (bytes + 1) & ~1;
+    if (bytes > ARENA_BYTES - g_arenaUsed) return 0;
+
+    p = &s_arena[g_arenaUsed];
+    g_arenaUsed += bytes;
+    if (g_arenaUsed > g_arenaPeak[g_arenaTag]) g_arenaPeak[g_arenaTag] = g_arenaUsed;
+    return p;
+}
+
+u16 arena_mark(void) {
+    return g_arenaUsed;
+}
+
+void arena_release(u16 mark) {
+    g_arenaUsed = mark;
+}
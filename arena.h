@@ -0,0 +1,36 @@
+#ifndef STARSHMUP_ARENA_H
+#define STARSHMUP_ARENA_H
+
+#include <snes.h>
+
+#include "scenes.h"
+
+// Scene-scoped bump allocator over one reserved WRAM block.
+//
+// Allocations belong to the current tag: ARENA_TAG_BOOT until the first
+// arena_reset(), then the scene passed to it. game.c resets on every scene
+// change, which frees everything at once, so load-time buffers and
+// per-scene pools share the block instead of each being a static array.
+// Nothing allocated may be referenced after its scene ends (including by
+// queued transfers or jobs). arena_mark()/arena_release() free temporaries
+// within a scene.
+#define ARENA_BYTES 0xA00  // The 2 KB boot starfield map plus headroom
+#define ARENA_TAG_BOOT SCENE_COUNT
+
+extern u16 g_arenaUsed;
+extern u8 g_arenaTag;
+
+// High-water mark in bytes per tag (indexed by Scene, then ARENA_TAG_BOOT),
+// kept across resets
+extern u16 g_arenaPeak[SCENE_COUNT + 1];
+
+// Free everything and tag later allocations with scene
+void arena_reset(u8 scene);
+
+// bytes from the arena, rounded up to even, or NULL if it does not fit
+void* arena_alloc(u16 bytes);
+
+u16 arena_mark(void);
+void arena_release(u16 mark);
+
+#endif
@@ -0,0 +1,70 @@
+#include <snes.h>
+
+#include "bcd.h"
+
+static void saturate(Bcd* v) {
+    u8 i;
+    for (i = 0; i < BCD_BYTES; i++) {
+        v->b[i] = 0x99;
+    }
+}
+
+void bcd_clear(Bcd* v) {
+    u8 i;
+    for (i = 0; i < BCD_BYTES; i++) {
+        v->b[i] = 0;
+    }
+}
+
+void bcd_inc(Bcd* v) {
+    u8 i, d;
+
+    for (i = 0; i < BCD_BYTES; i++) {
+        d = v->b[i];
+        if ((d & 0x0F) != 0x09) {
+            v->b[i] = d + 1;
+            return;
+        }
+        if (d != 0x99) {
+            v->b[i] = (d & 0xF0) + 0x10;  // x9 -> (x+1)0
+            return;
+        }
+        v->b[i] = 0x00;  // 99 -> 00, carry into the next byte
+    }
+    saturate(v);
+}
+
+void bcd_add(Bcd* dst, const Bcd* src) {
+    u8 i, lo, hi, carry = 0;
+
+    for (i = 0; i < BCD_BYTES; i++) {
+        lo = (dst->b[i] & 0x0F) + (src->b[i] & 0x0F) + carry;
+        hi = (dst->b[i] >> 4) + (src->b[i] >> 4);
+        if (lo > 9) {
+            lo -= 10;
+            hi++;
+        }
+        carry = 0;
+        if (hi > 9) {
+            hi -= 10;
+            carry = 1;
+        }
+        dst->b[i] = (u8)((hi << 4) | lo);
+    }
+    if (carry) saturate(dst);
+}
+
+void bcd_to_str(const Bcd* v, char* out) {
+    u8 i = BCD_DIGITS - 1;
+    u8 n = 0;
+
+    // Skip leading zeros, keeping at least the ones digit
+    while (i > 0 && BCD_DIGIT(v, i) == 0) i--;
+
+    for (;;) {
+        out[n++] = '0' + BCD_DIGIT(v, i);
+        if (i == 0) break;
+        i--;
+    }
+    out[n] = '\0';
+}
@@ -0,0 +1,30 @@
+#ifndef STARSHMUP_BCD_H
+#define STARSHMUP_BCD_H
+
+#include <snes.h>
+
+// Packed-BCD counters: two decimal digits per byte, least significant byte
+// first. Display code reads digits directly, so no division is ever needed.
+#define BCD_BYTES 3
+#define BCD_DIGITS (BCD_BYTES * 2)
+
+typedef struct Bcd {
+    u8 b[BCD_BYTES];
+} Bcd;
+
+void bcd_clear(Bcd* v);
+
+// Add one; saturates at all nines
+void bcd_inc(Bcd* v);
+
+// dst += src; saturates at all nines
+void bcd_add(Bcd* dst, const Bcd* src);
+
+// Digit i (0 = ones)
+#define BCD_DIGIT(v, i) \
+    ((u8)(((i) & 1) ? ((v)->b[(i) >> 1] >> 4) : ((v)->b[(i) >> 1] & 0x0F)))
+
+// Decimal text without leading zeros. out must hold BCD_DIGITS + 1 chars.
+void bcd_to_str(const Bcd* v, char* out);
+
+#endif
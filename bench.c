@@ -0,0 +1,103 @@
+#include <snes.h>
+
+#include "bench.h"
+#include "prof.h"
+
+#ifdef BENCH
+
+// NTSC timing: NMI (and snes_vblank_count) fires at the start of line 225
+#define BENCH_NMI_LINE 225
+#define BENCH_FRAME_LINES 262
+
+typedef struct BenchStep {
+    u16 frames;
+    u16 pad;
+} BenchStep;
+
+// Leave the title, then cross between opposite corners and hold still in
+// each, firing diagonally across the screen while enemies converge.
+// One-frame taps set the aim without moving far.
+static const BenchStep s_script[] = {
+    { 2, 0 },
+    { 1, KEY_START },
+    { 120, KEY_UP | KEY_LEFT },
+    { 1, KEY_DOWN | KEY_RIGHT },
+    { 480, 0 },
+    { 120, KEY_DOWN | KEY_RIGHT },
+    { 1, KEY_UP | KEY_LEFT },
+    { 480, 0 },
+};
+#define BENCH_SCRIPT_LEN (sizeof(s_script) / sizeof(s_script[0]))
+#define BENCH_LOOP_STEP 2  // Steps before this one run once
+
+BenchResult g_bench;
+
+static u8 s_step;
+static u16 s_left;
+static u16 s_lastCount;
+static u16 s_vblankAt;  // Absolute line (see abs_line) of the last VBlank
+
+// Lines since an arbitrary origin: the VBlank count advances at the NMI
+// line, so lines are measured from there. If the NMI lands between reading
+// the count and the counters, read both again.
+static u16 abs_line(void) {
+    u16 count, line, rel;
+
+    do {
+        count = snes_vblank_count;
+        line = prof_line();
+    } while (count != snes_vblank_count);
+
+    rel = (line >= BENCH_NMI_LINE) ? line - BENCH_NMI_LINE
+                                   : line + (BENCH_FRAME_LINES - BENCH_NMI_LINE);
+    return count * BENCH_FRAME_LINES + rel;
+}
+
+void bench_init(void) {
+    g_bench.magic[0] = 'B';
+    g_bench.magic[1] = 'N';
+    g_bench.magic[2] = 'C';
+    g_bench.magic[3] = 'H';
+    g_bench.scenario = BENCH;
+    s_step = 0;
+    s_left = s_script[0].frames;
+    s_lastCount = snes_vblank_count;
+    s_vblankAt = abs_line();
+}
+
+u16 bench_pad(void) {
+    u16 pad;
+
+    if (s_left == 0) {
+        if (++s_step == BENCH_SCRIPT_LEN) s_step = BENCH_LOOP_STEP;
+        s_left = s_script[s_step].frames;
+    }
+    pad = s_script[s_step].pad;
+    s_left--;
+    return pad;
+}
+
+void bench_vblank(void) {
+    u16 count = snes_vblank_count;
+
+    if (!g_bench.done && count - s_lastCount > 1) {
+        g_bench.lag_frames += count - s_lastCount - 1;
+    }
+    s_lastCount = count;
+    s_vblankAt = abs_line();
+}
+
+void bench_frame_end(void) {
+    u16 used;
+
+    if (g_bench.done) return;
+
+    used = abs_line() - s_vblankAt;
+    if (used > g_bench.peak_lines) {
+        g_bench.peak_lines = used;
+        g_bench.peak_frame = g_bench.frames;
+    }
+    if (++g_bench.frames == BENCH_FRAMES) g_bench.done = 1;
+}
+
+#endif
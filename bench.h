@@ -0,0 +1,55 @@
+#ifndef STARSHMUP_BENCH_H
+#define STARSHMUP_BENCH_H
+
+#include <snes.h>
+
+// Stress-scenario benchmark builds (`make bench`). BENCH is a mask of the
+// scenarios below; every bench build also plays a fixed input script from
+// ROM, makes the player invulnerable and records results in g_bench.
+#define BENCH_BULLETS  0x01  // Autofire every frame
+#define BENCH_ENEMIES  0x02  // Population pinned at MAX_ENEMIES
+#define BENCH_HUD      0x04  // Both HUD counters change every frame
+#define BENCH_SFX      0x08  // Sound effects requested every frame
+#define BENCH_EBULLETS 0x10  // Enemy bullet rings every 16 frames
+
+#define BENCH_FRAMES 3600  // Frames measured: one minute at 60 Hz
+
+#ifdef BENCH
+
+#define BENCH_HAS(s) ((BENCH) & (s))
+
+// Results, readable from WRAM once done is set. Find g_bench through
+// starshmup.sym, or scan WRAM for the magic bytes.
+typedef struct BenchResult {
+    char magic[4];   // "BNCH"
+    u8 scenario;     // BENCH mask of this build
+    u8 done;         // Set after BENCH_FRAMES frames; counters stop
+    u16 frames;      // Frames measured so far
+    u16 lag_frames;  // VBlanks missed because a frame ran long
+    u16 peak_lines;  // Most scanlines one frame used, from VBlank to VBlank wait
+    u16 peak_frame;  // Frame number of peak_lines
+} BenchResult;
+
+extern BenchResult g_bench;
+
+void bench_init(void);
+
+// Pad state for this frame from the ROM input script
+u16 bench_pad(void);
+
+// Call right after WaitForVBlank() returns / right before calling it
+void bench_vblank(void);
+void bench_frame_end(void);
+
+#define BENCH_VBLANK() bench_vblank()
+#define BENCH_FRAME_END() bench_frame_end()
+
+#else
+
+#define BENCH_HAS(s) 0
+#define BENCH_VBLANK()
+#define BENCH_FRAME_END()
+
+#endif
+
+#endif
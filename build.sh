@@ -4,17 +4,20 @@ cd "$(dirname "$0")"
 
 case "${1:-}" in
     clean)
-        rm -f *.obj *.ps *.sfc *.sym linkfile main.asm gfx.asm 2>/dev/null || true
+        rm -f *.obj *.ps *.sfc *.sym linkfile main.asm gfx.asm bullets.asm enemies.asm rng.asm grid.asm collide.asm oam.asm xfer.asm hud.asm bcd.asm hwmath.asm trig.asm game.asm prof.asm bench.asm parallax.asm waves.asm wave_scripts.asm jobs.asm kcheck.asm replay.asm ebullets.asm arena.asm mbench.asm 2>/dev/null || true
         echo "Cleaned."
         exit 0
         ;;
     debug)
         export PVSNESLIB_DEBUG=1
         ;;
+    fast)
+        export FASTROM=1
+        ;;
 esac
 
 # Clean intermediates (preserve hdr.asm)
-rm -f *.obj *.ps linkfile main.asm gfx.asm 2>/dev/null || true
+rm -f *.obj *.ps linkfile main.asm gfx.asm bullets.asm enemies.asm rng.asm grid.asm collide.asm oam.asm xfer.asm hud.asm bcd.asm hwmath.asm trig.asm game.asm prof.asm bench.asm parallax.asm waves.asm wave_scripts.asm jobs.asm kcheck.asm replay.asm ebullets.asm arena.asm mbench.asm 2>/dev/null || true
 
 # Build (filter noise, ignore sed error on macOS)
 make 2>&1 | grep -v "debug mode is\|compilation is enabled\|unterminated substitute\|sed:\|make: \*\*\*"
@@ -0,0 +1,66 @@
+#include <snes.h>
+
+#include "bullets.h"
+#include "game.h"
+#include "trig.h"
+
+Bullet g_bullets[MAX_BULLETS];
+u8 g_bulletLive[MAX_BULLETS];
+u8 g_bulletCount = 0;
+
+u8 g_bulletFree[MAX_BULLETS];
+u8 g_bulletFreeCount = 0;
+
+void bullets_clear(void) {
+    u8 i;
+    for (i = 0; i < MAX_BULLETS; i++) {
+        g_bulletFree[i] = (MAX_BULLETS - 1) - i;
+    }
+    g_bulletFreeCount = MAX_BULLETS;
+    g_bulletCount = 0;
+}
+
+u8 bullets_spawn(s16 x, s16 y, s16 vx, s16 vy) {
+    u8 slot;
+    Bullet* b;
+
+    if (g_bulletFreeCount == 0) return BULLET_NONE;
+
+    slot = g_bulletFree[--g_bulletFreeCount];
+    g_bulletLive[g_bulletCount++] = slot;
+
+    b = &g_bullets[slot];
+    b->x = x;
+    b->y = y;
+    b->vx = vx;
+    b->vy = vy;
+    b->fx = 0;
+    b->fy = 0;
+    return slot;
+}
+
+void bullets_kill(u8 n) {
+    const u8 slot = g_bulletLive[n];
+
+    g_bulletLive[n] = g_bulletLive[--g_bulletCount];
+    g_bulletFree[g_bulletFreeCount++] = slot;
+}
+
+void bullets_step_c(void) {
+    Bullet* b;
+    u8 n = 0;
+
+    while (n < g_bulletCount) {
+        b = &g_bullets[g_bulletLive[n]];
+
+        FX_STEP(b->x, b->fx, b->vx);
+        FX_STEP(b->y, b->fy, b->vy);
+
+        if (b->x < -BULLET_SIZE || b->x > SCREEN_W + BULLET_SIZE ||
+            b->y < -BULLET_SIZE || b->y > SCREEN_H + BULLET_SIZE) {
+            bullets_kill(n);
+            continue;
+        }
+        n++;
+    }
+}
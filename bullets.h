@@ -0,0 +1,50 @@
+#ifndef STARSHMUP_BULLETS_H
+#define STARSHMUP_BULLETS_H
+
+#include <snes.h>
+
+// Player bullet pool
+#define MAX_BULLETS 64
+#define BULLET_NONE 0xFF
+
+typedef struct Bullet {
+    s16 x, y;    // Whole pixels
+    s16 vx, vy;  // 8.8 pixels per frame
+    u8 fx, fy;   // Sub-pixel
+} Bullet;
+
+// Slot storage. Only slots listed in g_bulletLive are meaningful.
+extern Bullet g_bullets[MAX_BULLETS];
+
+// Dense list of live slot indices: entries [0, g_bulletCount) are in use.
+extern u8 g_bulletLive[MAX_BULLETS];
+extern u8 g_bulletCount;
+
+// Free slot stack: entries [0, g_bulletFreeCount) are available. Shared
+// with the asm kernel (kernels.asm).
+extern u8 g_bulletFree[MAX_BULLETS];
+extern u8 g_bulletFreeCount;
+
+void bullets_clear(void);
+
+// Take a slot from the free list. Returns the slot index, or BULLET_NONE when full.
+u8 bullets_spawn(s16 x, s16 y, s16 vx, s16 vy);
+
+// Release the bullet at position n of the live list. The last live entry is
+// swapped into position n, so callers walking the list must not advance n.
+void bullets_kill(u8 n);
+
+// Move every live bullet one frame and kill those past the screen edge
+// (more than BULLET_SIZE outside). Killing uses bullets_kill() order, so
+// the live list ends up the same from either version. ASM_KERNELS builds
+// use the hand-written kernel; the C one stays as its reference. The host
+// build runs the kernel on a 65816 simulator (host/sim65.h).
+void bullets_step_c(void);
+void bullets_step_asm(void);
+#ifdef ASM_KERNELS
+#define bullets_step bullets_step_asm
+#else
+#define bullets_step bullets_step_c
+#endif
+
+#endif
@@ -0,0 +1,126 @@
+#include <snes.h>
+
+#include "collide.h"
+#include "enemies.h"
+#include "game.h"
+#include "gfx.h"
+#include "grid.h"
+
+u16 g_collidePairTests = 0;
+u8 g_collideList[MAX_ENEMIES];
+
+// Negative array size, and a compile error, if a mask lookup below would
+// land on the wrong column (gfx.h)
+typedef char MaskTilesOk[(GFX_MASK_TILE_OK(GFX_TILE_PLAYER, PLAYER_SIZE) &&
+                          GFX_MASK_TILE_OK(GFX_TILE_ENEMY, ENEMY_SIZE) &&
+                          GFX_MASK_TILE_OK(GFX_TILE_BULLET, BULLET_SIZE)) ? 1 : -1];
+
+static s16 iabs_s16(s16 v) {
+    return (v < 0) ? (s16)-v : v;
+}
+
+void collide_begin_frame(void) {
+#ifdef COLLIDE_BRUTE_FORCE
+    u8 i;
+
+    for (i = 0; i < MAX_ENEMIES; i++) {
+        g_collideList[i] = i;
+    }
+#endif
+    g_collidePairTests = 0;
+}
+
+// Negative array size, and a compile error, if the player scan's symmetric
+// range no longer means the two boxes overlap
+typedef char PlayerEnemySameSize[(PLAYER_SIZE == ENEMY_SIZE) ? 1 : -1];
+
+static u8 box_scan(s16 bx, s16 by, u16 first, u16 n, s16 radius) {
+    u8 i, e;
+
+    for (i = (u8)first; i < n; i++) {
+        e = g_collideList[i];
+        if (iabs_s16(bx - g_enemyX[e]) < radius && iabs_s16(by - g_enemyY[e]) < radius) {
+            return i;
+        }
+    }
+    return COLLIDE_NONE;
+}
+
+u8 collide_scan_c(s16 bx, s16 by, u16 first, u16 n) {
+    return box_scan(bx, by, first, n, BULLET_COLLISION_RADIUS);
+}
+
+u8 collide_player_scan_c(u16 first, u16 n) {
+    return box_scan(g_game.player_x, g_game.player_y, first, n, PLAYER_COLLISION_RADIUS);
+}
+
+// Narrow phase: mask b has its top-left at (dx, dy) from mask a's, with
+// both offsets inside (-16, 16) once the boxes overlap. Only the rows the
+// two share are tested, each one shift and one AND.
+static u8 masks_overlap(const u16* a, u8 ah, const u16* b, u8 bh, s16 dx, s16 dy) {
+    u8 rows;
+    u16 row;
+
+    if (dy >= 0) {
+        a += dy;
+        rows = (u8)(ah - dy);
+    } else {
+        b -= dy;
+        rows = ah;
+        bh = (u8)(bh + dy);
+    }
+    if (rows > bh) rows = bh;
+
+    while (rows--) {
+        row = *b++;
+        row = (dx >= 0) ? (u16)(row >> dx) : (u16)(row << -dx);
+        if (*a++ & row) return 1;
+    }
+    return 0;
+}
+
+u8 collide_bullet_enemy(s16 cx, s16 cy) {
+#ifdef COLLIDE_BRUTE_FORCE
+    const u8 n = g_enemyCount;
+#else
+    const u8 n = grid_gather(cx, cy, g_collideList);
+#endif
+    const s16 bx = cx - (BULLET_SIZE / 2);
+    const s16 by = cy - (BULLET_SIZE / 2);
+    u8 i = 0, e;
+
+    g_collidePairTests += n;
+    // Compare against enemy top-left to skip recomputing enemy centers; a
+    // box hit whose pixels miss resumes the scan after it
+    while ((i = collide_scan(cx - (ENEMY_SIZE / 2), cy - (ENEMY_SIZE / 2), i, n)) != COLLIDE_NONE) {
+        e = g_collideList[i];
+        if (masks_overlap(GFX_MASK(GFX_TILE_ENEMY), ENEMY_SIZE, GFX_MASK(GFX_TILE_BULLET),
+                          BULLET_SIZE, bx - g_enemyX[e], by - g_enemyY[e])) {
+            return e;
+        }
+        i++;
+    }
+    return COLLIDE_NONE;
+}
+
+u8 collide_player_enemy(void) {
+    const s16 x = g_game.player_x;
+    const s16 y = g_game.player_y;
+    u8 i = 0, e;
+#ifdef COLLIDE_BRUTE_FORCE
+    const u8 n = g_enemyCount;
+#else
+    const u8 n = grid_gather(x + (PLAYER_SIZE / 2), y + (PLAYER_SIZE / 2), g_collideList);
+#endif
+
+    g_collidePairTests += n;
+    while ((i = collide_player_scan(i, n)) != COLLIDE_NONE) {
+        e = g_collideList[i];
+        if (masks_overlap(GFX_MASK(GFX_TILE_ENEMY), ENEMY_SIZE, GFX_MASK(GFX_TILE_PLAYER),
+                          PLAYER_SIZE, x - g_enemyX[e], y - g_enemyY[e])) {
+            return 1;
+        }
+        i++;
+    }
+    return 0;
+}
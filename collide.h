@@ -0,0 +1,55 @@
+#ifndef STARSHMUP_COLLIDE_H
+#define STARSHMUP_COLLIDE_H
+
+#include <snes.h>
+
+#include "enemies.h"
+
+// Bullet/player vs enemy collision. Candidates come from the broadphase grid;
+// build with COLLIDE_BRUTE_FORCE defined to test every enemy instead.
+#define COLLIDE_NONE 0xFF
+
+// Candidate pairs tested since the last collide_begin_frame()
+extern u16 g_collidePairTests;
+
+void collide_begin_frame(void);
+
+// First enemy hit by the bullet centered at (cx, cy), or COLLIDE_NONE.
+// Boxes are tested first (collide_scan); only when they overlap are the
+// sprites' 1-bit masks (gfx.h) shifted into line and ANDed row by row.
+u8 collide_bullet_enemy(s16 cx, s16 cy);
+
+// Candidate enemy indices for the scan below, filled by grid_gather() (or
+// with every enemy for COLLIDE_BRUTE_FORCE). Shared with kernels.asm.
+extern u8 g_collideList[MAX_ENEMIES];
+
+// Position in g_collideList, from first up to n, of the first enemy whose
+// top-left is within BULLET_COLLISION_RADIUS of (bx, by) on both axes, or
+// COLLIDE_NONE. The broad phase of collide_bullet_enemy(); ASM_KERNELS
+// builds use the hand-written kernel, the C one stays as its reference.
+// first and n are u16 so every argument is one 16-bit word on the stack.
+// As with bullets_step(), the host build simulates the kernel.
+u8 collide_scan_c(s16 bx, s16 by, u16 first, u16 n);
+u8 collide_scan_asm(s16 bx, s16 by, u16 first, u16 n);
+#ifdef ASM_KERNELS
+#define collide_scan collide_scan_asm
+#else
+#define collide_scan collide_scan_c
+#endif
+
+// The same scan for the player at (g_game.player_x, g_game.player_y),
+// within PLAYER_COLLISION_RADIUS: the player and enemy boxes overlap. The
+// asm kernel reads the position through the direct page (game.h).
+u8 collide_player_scan_c(u16 first, u16 n);
+u8 collide_player_scan_asm(u16 first, u16 n);
+#ifdef ASM_KERNELS
+#define collide_player_scan collide_player_scan_asm
+#else
+#define collide_player_scan collide_player_scan_c
+#endif
+
+// Returns 1 if any enemy overlaps the player (g_game.player_x / player_y):
+// box test, then masks.
+u8 collide_player_enemy(void);
+
+#endif
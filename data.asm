@@ -8,4 +8,14 @@ tilfont:
 palfont:
 .incbin "pvsneslibfont.pal"
 
+; Generated from gfx/*.png by `make assets`
+gfx_sprites_lz:
+.incbin "gfx/sprites.pic.lz"
+
+gfx_starfield_lz:
+.incbin "gfx/starfield.pic.lz"
+
+gfx_starfield_pal:
+.incbin "gfx/starfield.pal"
+
 .ends
@@ -0,0 +1,170 @@
+#include <snes.h>
+
+#include "arena.h"
+#include "ebullets.h"
+#include "game.h"
+#include "gfx.h"
+#include "oam.h"
+#include "trig.h"
+
+s16 g_ebX[EBULLET_MAX];
+s16 g_ebY[EBULLET_MAX];
+u8 g_ebFx[EBULLET_MAX];
+u8 g_ebFy[EBULLET_MAX];
+s16 g_ebVx[EBULLET_MAX];
+s16 g_ebVy[EBULLET_MAX];
+u8 g_ebLive[EBULLET_MAX];
+u8 g_ebCount = 0;
+
+static u8 s_head;   // Next ring slot to spawn into
+static u8 s_phase;  // Parity of the slots moved this frame
+
+// A volley is count shots step angle units apart, centred on the angle to
+// the player (aimed) or on a running angle that turns by turn per volley
+typedef struct EbPattern {
+    u8 count;
+    u8 step;
+    u8 aimed;
+    u8 turn;
+    s16 speed;     // 8.8 pixels per frame
+    u8 volleys;
+    u8 interval;   // Frames between volleys
+} EbPattern;
+
+// Indexed by EB_PAT_*
+static const EbPattern s_patterns[EB_PAT_COUNT] = {
+    { 5, 12, 1, 0, 0x0180, 1, 1 },    // EB_PAT_SPREAD
+    { 16, 16, 0, 6, 0x0100, 3, 20 },  // EB_PAT_RING
+    { 1, 0, 1, 0, 0x0200, 5, 6 },     // EB_PAT_BURST
+};
+
+typedef struct EbEmitter {
+    u8 pattern;
+    u8 volleys;  // Left to fire; 0 = emitter free
+    u8 timer;    // Frames to the next volley
+    u8 angle;    // Running angle for unaimed patterns
+    s16 x, y;
+} EbEmitter;
+
+// Emitters are per-game working data from the gameplay scene's arena.
+// They are only reached through a pointer per emitter, so unlike the slot
+// arrays (kept static for absolute-indexed access in the hot loops) this
+// costs nothing per access. 0 if the arena was full: volleys are dropped.
+static EbEmitter* s_emitters;
+
+void ebullets_clear(void) {
+    u8 i;
+
+    for (i = 0; i < EBULLET_MAX; i++) {
+        g_ebLive[i] = 0;
+    }
+    s_emitters = (EbEmitter*)arena_alloc(EB_EMITTERS * sizeof(EbEmitter));
+    for (i = 0; s_emitters && i < EB_EMITTERS; i++) {
+        s_emitters[i].volleys = 0;
+    }
+    g_ebCount = 0;
+    s_head = 0;
+}
+
+static void spawn(s16 x, s16 y, u8 angle, s16 speed) {
+    const u8 i = s_head;
+
+    s_head = (s_head + 1) & (EBULLET_MAX - 1);
+    if (!g_ebLive[i]) {
+        g_ebLive[i] = 1;
+        g_ebCount++;
+    }
+    g_ebX[i] = x;
+    g_ebY[i] = y;
+    g_ebFx[i] = 0;
+    g_ebFy[i] = 0;
+    fx_polar(angle, speed * 2, &g_ebVx[i], &g_ebVy[i]);
+}
+
+void ebullets_fire(u8 pattern, s16 x, s16 y) {
+    EbEmitter* em;
+    u8 i;
+
+    if (!s_emitters) return;
+    for (i = 0; i < EB_EMITTERS; i++) {
+        em = &s_emitters[i];
+        if (em->volleys) continue;
+        em->pattern = pattern;
+        em->volleys = s_patterns[pattern].volleys;
+        em->timer = 0;
+        em->angle = 0;
+        em->x = x;
+        em->y = y;
+        return;
+    }
+}
+
+static void fire_volleys(s16 px, s16 py) {
+    const s16 tx = px + (PLAYER_SIZE / 2) - (EBULLET_SIZE / 2);
+    const s16 ty = py + (PLAYER_SIZE / 2) - (EBULLET_SIZE / 2);
+    const EbPattern* p;
+    EbEmitter* em;
+    u8 i, n, angle;
+
+    if (!s_emitters) return;
+    for (i = 0; i < EB_EMITTERS; i++) {
+        em = &s_emitters[i];
+        if (!em->volleys) continue;
+        if (em->timer) {
+            em->timer--;
+            continue;
+        }
+
+        p = &s_patterns[em->pattern];
+        angle = p->aimed ? fx_atan2(tx - em->x, ty - em->y) : em->angle;
+        angle -= (u8)(((p->count - 1) * p->step) >> 1);
+        for (n = 0; n < p->count; n++) {
+            spawn(em->x, em->y, angle, p->speed);
+            angle += p->step;
+        }
+        em->angle += p->turn;
+        em->timer = p->interval - 1;
+        em->volleys--;
+    }
+}
+
+u8 ebullets_update(s16 px, s16 py) {
+    // Bullet top-left range that puts its center within the hit radius
+    const s16 hx = px + (PLAYER_SIZE / 2) - (EBULLET_SIZE / 2) - EBULLET_HIT_RADIUS;
+    const s16 hy = py + (PLAYER_SIZE / 2) - (EBULLET_SIZE / 2) - EBULLET_HIT_RADIUS;
+    u8 i, hit = 0;
+
+    fire_volleys(px, py);
+
+    s_phase ^= 1;
+    if (!g_ebCount) return 0;
+
+    for (i = s_phase; i < EBULLET_MAX; i += 2) {
+        if (!g_ebLive[i]) continue;
+
+        FX_STEP(g_ebX[i], g_ebFx[i], g_ebVx[i]);
+        FX_STEP(g_ebY[i], g_ebFy[i], g_ebVy[i]);
+
+        // Unsigned compares: one per axis for the on-screen and hit ranges
+        if ((u16)(g_ebX[i] + EBULLET_SIZE) > SCREEN_W + EBULLET_SIZE ||
+            (u16)(g_ebY[i] + EBULLET_SIZE) > SCREEN_H + EBULLET_SIZE) {
+            g_ebLive[i] = 0;
+            g_ebCount--;
+            continue;
+        }
+        if ((u16)(g_ebX[i] - hx) <= 2 * EBULLET_HIT_RADIUS &&
+            (u16)(g_ebY[i] - hy) <= 2 * EBULLET_HIT_RADIUS) {
+            hit = 1;
+        }
+    }
+    return hit;
+}
+
+void ebullets_draw(void) {
+    u8 i;
+
+    if (!g_ebCount) return;
+    for (i = 0; i < EBULLET_MAX; i++) {
+        if (g_ebLive[i]) oam_draw(&g_msEnemyBullet, g_ebX[i], g_ebY[i]);
+    }
+}
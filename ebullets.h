@@ -0,0 +1,57 @@
+#ifndef STARSHMUP_EBULLETS_H
+#define STARSHMUP_EBULLETS_H
+
+#include <snes.h>
+
+// Enemy bullets: a ring-buffer pool of plain slots. Each spawn takes the
+// next slot in the ring, recycling the oldest bullet if it is still alive,
+// so there is no free list to maintain.
+//
+// Movement is interleaved: even slots move on one frame and odd slots on
+// the next, each by twice its per-frame velocity (stored pre-doubled), so
+// a frame walks half the pool. The player hit test rides along with each
+// move and is two unsigned compares per bullet.
+#define EBULLET_MAX 128  // Power of two: the ring index wraps with a mask
+#define EBULLET_SIZE 8
+#define EBULLET_HIT_RADIUS 3  // Player core hitbox, around the sprite centers
+
+// Emitter patterns (s_patterns in ebullets.c)
+enum {
+    EB_PAT_SPREAD,  // Fan of shots aimed at the player
+    EB_PAT_RING,    // Full circle, turning a little each volley
+    EB_PAT_BURST,   // Single shots re-aimed at the player, in quick succession
+    EB_PAT_COUNT
+};
+
+// Bursts still firing. A pattern keeps its origin; patterns started with
+// every emitter busy are dropped.
+#define EB_EMITTERS 8
+
+// Slot storage; a slot is in use when g_ebLive is nonzero
+extern s16 g_ebX[EBULLET_MAX];
+extern s16 g_ebY[EBULLET_MAX];
+extern u8 g_ebFx[EBULLET_MAX];
+extern u8 g_ebFy[EBULLET_MAX];
+extern s16 g_ebVx[EBULLET_MAX];  // 8.8 per update, i.e. per 2 frames
+extern s16 g_ebVy[EBULLET_MAX];
+extern u8 g_ebLive[EBULLET_MAX];
+extern u8 g_ebCount;
+
+// Empty the pool and stop every emitter. The emitter table is allocated
+// from the current scene's arena (arena.h), so this runs when gameplay
+// starts, after the scene change.
+void ebullets_clear(void);
+
+// Start a pattern with its bullets coming from (x, y) (bullet top-left)
+void ebullets_fire(u8 pattern, s16 x, s16 y);
+
+// Fire due volleys, then move this frame's half of the pool and cull it.
+// (px, py) is the player top-left; returns 1 if a moved bullet hit it.
+u8 ebullets_update(s16 px, s16 py);
+
+// Stage every live bullet with oam_draw(). With a full pool there are more
+// objects than OAM slots; the rotating window (oam.h) makes the ones left
+// out differ each frame, so no bullet that can hit the player stays unseen.
+void ebullets_draw(void);
+
+#endif
@@ -0,0 +1,117 @@
+#include <snes.h>
+
+#include "enemies.h"
+#include "game.h"
+#include "grid.h"
+#include "hwmath.h"
+#include "rng.h"
+#include "trig.h"
+
+s16 g_enemyX[MAX_ENEMIES];
+s16 g_enemyY[MAX_ENEMIES];
+u8 g_enemyFx[MAX_ENEMIES];
+u8 g_enemyFy[MAX_ENEMIES];
+s16 g_enemyVx[MAX_ENEMIES];
+s16 g_enemyVy[MAX_ENEMIES];
+u8 g_enemyHp[MAX_ENEMIES];
+u8 g_enemyType[MAX_ENEMIES];
+u8 g_enemyState[MAX_ENEMIES];
+u8 g_enemyCount = 0;
+
+typedef void (*EnemyUpdateFn)(u8 i, s16 tx, s16 ty);
+
+// Homing toward target. State counts down to the next re-aim, which is an
+// atan2 table lookup; spawn times spread re-aims across frames.
+static void update_biobomb(u8 i, s16 tx, s16 ty) {
+    if (g_enemyState[i] == 0) {
+        fx_polar(fx_atan2(tx - g_enemyX[i], ty - g_enemyY[i]), ENEMY_SPEED,
+                 &g_enemyVx[i], &g_enemyVy[i]);
+        g_enemyState[i] = ENEMY_REAIM_FRAMES - 1;
+    } else {
+        g_enemyState[i]--;
+    }
+    FX_STEP(g_enemyX[i], g_enemyFx[i], g_enemyVx[i]);
+    FX_STEP(g_enemyY[i], g_enemyFy[i], g_enemyVy[i]);
+}
+
+// Per-type tables, indexed by EnemyType
+static const EnemyUpdateFn s_updateFn[ENEMY_TYPE_COUNT] = {
+    update_biobomb,
+};
+
+// HP at level 1; each level above adds one more
+static const u8 s_baseHp[ENEMY_TYPE_COUNT] = {
+    1,
+};
+
+void enemies_clear(void) {
+    g_enemyCount = 0;
+    grid_clear();
+}
+
+u8 enemy_hp_for_level(u8 type, u16 level) {
+    const u16 hp = s_baseHp[type] + (level - 1);
+    return (hp > 255) ? 255 : (u8)hp;
+}
+
+u8 enemies_spawn(u8 type, s16 x, s16 y, u16 level) {
+    u8 i;
+
+    if (g_enemyCount >= MAX_ENEMIES) return 0xFF;
+
+    i = g_enemyCount++;
+    g_enemyX[i] = x;
+    g_enemyY[i] = y;
+    g_enemyFx[i] = 0;
+    g_enemyFy[i] = 0;
+    g_enemyVx[i] = 0;
+    g_enemyVy[i] = 0;
+    g_enemyHp[i] = enemy_hp_for_level(type, level);
+    g_enemyType[i] = type;
+    g_enemyState[i] = 0;
+    grid_insert(i, grid_cell_of(x + (ENEMY_SIZE / 2), y + (ENEMY_SIZE / 2)));
+    return i;
+}
+
+u8 enemies_spawn_edge(u8 type, u16 level) {
+    const u16 r = rng_next_u16();
+    const u8 edge = r & 3;
+    const s16 max_x = SCREEN_W - ENEMY_SIZE;
+    const s16 max_y = SCREEN_H - ENEMY_SIZE;
+
+    switch (edge) {
+        case 0:  // top
+            return enemies_spawn(type, hw_range(r, max_x + 1), 0, level);
+        case 1:  // bottom
+            return enemies_spawn(type, hw_range(r, max_x + 1), max_y, level);
+        case 2:  // left
+            return enemies_spawn(type, 0, hw_range(r, max_y + 1), level);
+        default:  // right
+            return enemies_spawn(type, max_x, hw_range(r, max_y + 1), level);
+    }
+}
+
+void enemies_kill(u8 i) {
+    const u8 last = --g_enemyCount;
+
+    grid_remove(i);
+    if (i == last) return;
+    g_enemyX[i] = g_enemyX[last];
+    g_enemyY[i] = g_enemyY[last];
+    g_enemyFx[i] = g_enemyFx[last];
+    g_enemyFy[i] = g_enemyFy[last];
+    g_enemyVx[i] = g_enemyVx[last];
+    g_enemyVy[i] = g_enemyVy[last];
+    g_enemyHp[i] = g_enemyHp[last];
+    g_enemyType[i] = g_enemyType[last];
+    g_enemyState[i] = g_enemyState[last];
+    grid_renumber(last, i);
+}
+
+void enemies_update(s16 tx, s16 ty) {
+    u8 i;
+    for (i = 0; i < g_enemyCount; i++) {
+        s_updateFn[g_enemyType[i]](i, tx, ty);
+        grid_move(i, grid_cell_of(g_enemyX[i] + (ENEMY_SIZE / 2), g_enemyY[i] + (ENEMY_SIZE / 2)));
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef STARSHMUP_ENEMIES_H
+#define STARSHMUP_ENEMIES_H
+
+#include <snes.h>
+
+// Enemy table, stored as parallel arrays indexed by a single byte.
+// Live enemies are packed into [0, g_enemyCount); killing one moves the
+// last live enemy into its index. Spawn, kill and update keep the
+// broadphase grid (grid.h) in sync.
+#define MAX_ENEMIES 32
+
+typedef enum {
+    ENEMY_TYPE_BIOBOMB,  // Homes toward the target, re-aiming every ENEMY_REAIM_FRAMES
+    ENEMY_TYPE_COUNT
+} EnemyType;
+
+// Position in whole pixels plus sub-pixel byte; velocity in 8.8
+extern s16 g_enemyX[MAX_ENEMIES];
+extern s16 g_enemyY[MAX_ENEMIES];
+extern u8 g_enemyFx[MAX_ENEMIES];
+extern u8 g_enemyFy[MAX_ENEMIES];
+extern s16 g_enemyVx[MAX_ENEMIES];
+extern s16 g_enemyVy[MAX_ENEMIES];
+extern u8 g_enemyHp[MAX_ENEMIES];
+extern u8 g_enemyType[MAX_ENEMIES];
+// Per-type scratch byte owned by the type's update routine (cleared on spawn)
+extern u8 g_enemyState[MAX_ENEMIES];
+extern u8 g_enemyCount;
+
+void enemies_clear(void);
+
+// HP for a freshly spawned enemy of the given type at the given level
+u8 enemy_hp_for_level(u8 type, u16 level);
+
+// Spawn at (x, y). Returns the new index, or 0xFF when the table is full.
+u8 enemies_spawn(u8 type, s16 x, s16 y, u16 level);
+
+// Spawn at a random screen edge. Returns the new index, or 0xFF when full.
+u8 enemies_spawn_edge(u8 type, u16 level);
+
+// Remove enemy i. The last live enemy takes its index.
+void enemies_kill(u8 i);
+
+// Run each live enemy's per-type update. (tx, ty) is the homing target.
+void enemies_update(s16 tx, s16 ty);
+
+#endif
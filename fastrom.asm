@@ -0,0 +1,34 @@
+;---------------------------------------------------------------------------
+; FastROM entry for FASTROM builds (see hdr.asm)
+;
+; .BASE $80 only rebases the objects assembled with this project's
+; hdr.asm: the game's own asm and the 816-tcc output of its C files.
+; PVSnesLib's crt0 and library objects are prebuilt for banks $00+ and
+; stay there, running at SlowROM speed. The reset vector enters in bank
+; $00, and how crt0 reaches main() is not ours to rely on, so main() calls
+; this first: it sets MEMSEL and returns into the $80+ mirror of its
+; caller. From then on every JSL between the game's own routines targets
+; a $80+ label and stays fast.
+;---------------------------------------------------------------------------
+
+.include "hdr.asm"
+
+.SECTION ".fastrom_text" SUPERFREE
+
+; void fastrom_enter(void)
+;
+; With P pushed, the JSL return address is PCL at 2,s, PCH at 3,s and the
+; bank at 4,s. Setting bit 7 of the bank keeps the same ROM location.
+fastrom_enter:
+    php
+    sep #$20
+    .ACCU 8
+    lda #$01
+    sta.l $00420D       ; MEMSEL: $80-$FF banks at 3.58 MHz
+    lda 4,s
+    ora #$80
+    sta 4,s
+    plp
+    rtl
+
+.ENDS
@@ -0,0 +1,331 @@
+#include <snes.h>
+
+#include "arena.h"
+#include "bullets.h"
+#include "collide.h"
+#include "ebullets.h"
+#include "enemies.h"
+#include "game.h"
+#include "gfx.h"
+#include "hud.h"
+#include "oam.h"
+#include "prof.h"
+#include "rng.h"
+#include "scenes.h"
+#include "trig.h"
+#include "waves.h"
+#include "xfer.h"
+
+#ifdef HOST_BUILD
+GameState g_game;  // The ROM's is in the direct-page window (game_dp.asm)
+#endif
+
+// Negative array size, and a compile error, if GameState runs into the
+// kernels' scratch at the end of its page (so past 256 bytes as well)
+typedef char GameStateFitsDp[(sizeof(GameState) <= GAME_DP_SCRATCH &&
+                              GAME_DP_SCRATCH < GAME_DP_SIZE) ? 1 : -1];
+
+// Negative array size, and a compile error, if a frame's sprites could
+// overflow the OAM stage: anything past it would never be drawn, not even
+// by flickering
+typedef char SpritesFitStage[(MAX_BULLETS + MAX_ENEMIES + EBULLET_MAX <= OAM_STAGE_MAX) ? 1 : -1];
+
+// D-pad direction to angle, indexed [dy + 1][dx + 1] (centre unused)
+static const u8 s_dpadAngle[3][3] = {
+    { ANGLE_UP - 32, ANGLE_UP, ANGLE_UP + 32 },
+    { ANGLE_LEFT, 0, ANGLE_RIGHT },
+    { ANGLE_DOWN + 32, ANGLE_DOWN, ANGLE_DOWN - 32 },
+};
+
+static s16 clamp_s16(s16 v, s16 lo, s16 hi) {
+    if (v < lo) return lo;
+    if (v > hi) return hi;
+    return v;
+}
+
+// Every scene change goes through here, before the new scene's setup:
+// whatever the old scene allocated from the arena is freed
+static void set_scene(Scene scene) {
+    arena_reset(scene);
+    g_game.scene = scene;
+}
+
+// Reset gameplay state for a new game
+static void reset_gameplay(void) {
+    bcd_clear(&g_game.stats.kills);
+    bcd_clear(&g_game.stats.level);
+    bcd_inc(&g_game.stats.level);
+    g_game.level = 1;
+    g_game.kills = 0;
+    g_game.player_x = (SCREEN_W / 2) - (PLAYER_SIZE / 2);
+    g_game.player_y = (SCREEN_H / 2) - (PLAYER_SIZE / 2);
+    g_game.player_fx = 0;
+    g_game.player_fy = 0;
+    g_game.aim = ANGLE_UP;
+    g_game.fire_timer = 0;
+    g_game.frame = 0;
+    enemies_clear();
+    bullets_clear();
+    ebullets_clear();
+    waves_start(g_waveMain);
+}
+
+static void scroll_starfield(void) {
+    g_game.scroll_x++;
+    if ((g_game.frame & 3) == 0) g_game.scroll_y++;
+}
+
+static u8 step_gameplay(u16 pad) {
+    GameState* g = &g_game;
+    u8 events = 0;
+    s16 vx, vy;
+    s8 move_dx, move_dy;
+    u8 n, e, hit;
+    Bullet* b;
+
+    PROF_BEGIN(PROF_PLAYER);
+
+    // Read d-pad input
+    move_dx = 0;
+    move_dy = 0;
+    if (pad & KEY_LEFT) move_dx = -1;
+    else if (pad & KEY_RIGHT) move_dx = 1;
+    if (pad & KEY_UP) move_dy = -1;
+    else if (pad & KEY_DOWN) move_dy = 1;
+
+    // Update aim direction and move when the d-pad is held.
+    // Diagonals are normalized to PLAYER_SPEED.
+    if (move_dx || move_dy) {
+        g->aim = s_dpadAngle[move_dy + 1][move_dx + 1];
+        fx_polar(g->aim, PLAYER_SPEED, &vx, &vy);
+        FX_STEP(g->player_x, g->player_fx, vx);
+        FX_STEP(g->player_y, g->player_fy, vy);
+    }
+    g->player_x = clamp_s16(g->player_x, 0, SCREEN_W - PLAYER_SIZE);
+    g->player_y = clamp_s16(g->player_y, 0, SCREEN_H - PLAYER_SIZE);
+    oam_draw_priority(&g_msPlayer, g->player_x, g->player_y);
+
+    // Autofire (countdown instead of frame % AUTOFIRE_INTERVAL)
+    if (g->fire_timer) {
+        g->fire_timer--;
+    } else {
+        g->fire_timer = AUTOFIRE_INTERVAL - 1;
+        fx_polar(g->aim, BULLET_SPEED, &vx, &vy);
+        if (bullets_spawn(g->player_x + (PLAYER_SIZE / 2) - (BULLET_SIZE / 2),
+                          g->player_y + (PLAYER_SIZE / 2) - (BULLET_SIZE / 2),
+                          vx, vy) != BULLET_NONE) {
+            events |= GAME_EV_SHOT;
+        }
+    }
+
+    PROF_END(PROF_PLAYER);
+
+    // Enemies: per-type update (homing toward player)
+    PROF_BEGIN(PROF_ENEMIES);
+    enemies_update(g->player_x, g->player_y);
+    PROF_END(PROF_ENEMIES);
+
+    // Bullets: move and cull all of them, then collide and draw the
+    // survivors in one pass over the live list. Killing swaps the last
+    // live bullet into position n, so n only advances for survivors.
+    // Collision uses sprite centers; a bullet is spent on its first hit.
+    PROF_BEGIN(PROF_BULLETS);
+    bullets_step();
+    collide_begin_frame();
+    n = 0;
+    while (n < g_bulletCount) {
+        b = &g_bullets[g_bulletLive[n]];
+
+        e = collide_bullet_enemy(b->x + (BULLET_SIZE / 2), b->y + (BULLET_SIZE / 2));
+        if (e != COLLIDE_NONE) {
+            bullets_kill(n);
+            if (--g_enemyHp[e] == 0) {
+                events |= GAME_EV_ENEMY_DOWN;
+                enemies_kill(e);
+                g->kills++;
+                bcd_inc(&g->stats.kills);
+                hud_set_kills(&g->stats.kills);
+                // Level up every 10 kills: the ones digit wrapped
+                if ((g->stats.kills.b[0] & 0x0F) == 0) {
+                    g->level++;
+                    bcd_inc(&g->stats.level);
+                    hud_set_level(&g->stats.level);
+                    events |= GAME_EV_LEVEL_UP;
+                }
+            } else {
+                events |= GAME_EV_ENEMY_HIT;
+            }
+            continue;
+        }
+
+        oam_draw(&g_msBullet, b->x, b->y);
+        n++;
+    }
+    PROF_END(PROF_BULLETS);
+
+    // Spawns come from the wave script
+    PROF_BEGIN(PROF_WAVES);
+    waves_step();
+    PROF_END(PROF_WAVES);
+
+    // Enemy bullets: due volleys, then this frame's half of the pool,
+    // tested against the player as it moves
+    PROF_BEGIN(PROF_EBULLETS);
+#if BENCH_HAS(BENCH_EBULLETS)
+    if ((g->frame & 15) == 0 && g_enemyCount) {
+        ebullets_fire(EB_PAT_RING, g_enemyX[0] + (ENEMY_SIZE / 2) - (EBULLET_SIZE / 2),
+                      g_enemyY[0] + (ENEMY_SIZE / 2) - (EBULLET_SIZE / 2));
+    }
+#endif
+    hit = ebullets_update(g->player_x, g->player_y);
+    PROF_END(PROF_EBULLETS);
+
+    // Player-enemy collision: game over (contact / overlap, or a bullet)
+    PROF_BEGIN(PROF_COLLIDE);
+    e = collide_player_enemy() | hit;
+    PROF_END(PROF_COLLIDE);
+#ifdef BENCH
+    e = 0;  // Bench runs never end
+#endif
+    if (e) {
+        // Transition to game over
+        oam_begin();  // Drop this frame's sprites; oam_end() hides them
+        hud_hide();
+        set_scene(SCENE_GAMEOVER);
+        scene_gameover_enter(&g->stats);
+        return events | GAME_EV_PLAYER_DOWN;
+    }
+
+    scroll_starfield();
+
+#if BENCH_HAS(BENCH_HUD)
+    bcd_inc(&g->stats.kills);
+    hud_set_kills(&g->stats.kills);
+    bcd_inc(&g->stats.level);
+    hud_set_level(&g->stats.level);
+#endif
+#if BENCH_HAS(BENCH_SFX)
+    events |= GAME_EV_SHOT | GAME_EV_ENEMY_HIT | GAME_EV_ENEMY_DOWN;
+#endif
+
+    // Draw enemies
+    PROF_BEGIN(PROF_OAM);
+    for (e = 0; e < g_enemyCount; e++) {
+        oam_draw(&g_msEnemy, g_enemyX[e], g_enemyY[e]);
+    }
+    ebullets_draw();
+    PROF_END(PROF_OAM);
+
+    return events;
+}
+
+void game_init(void) {
+    set_scene(SCENE_TITLE);
+    g_game.frame = 0;
+    g_game.scroll_x = 0;
+    g_game.scroll_y = 0;
+    g_game.prev_pad = 0;
+    scene_title_enter();
+}
+
+u8 game_step(u16 pad) {
+    // Only trigger scene changes on button press, not hold
+    const u16 pressed = pad & ~g_game.prev_pad;
+    u8 events = 0;
+
+    oam_begin();
+
+    switch (g_game.scene) {
+        case SCENE_TITLE:
+            if ((pressed & KEY_START) && scene_title_update(pad) == SCENE_GAMEPLAY) {
+                events |= GAME_EV_CONFIRM;
+                set_scene(SCENE_GAMEPLAY);
+                reset_gameplay();
+                hud_show(&g_game.stats.level, &g_game.stats.kills);
+            }
+
+            // Scroll starfield even on title
+            scroll_starfield();
+            break;
+
+        case SCENE_GAMEPLAY:
+            events = step_gameplay(pad);
+            break;
+
+        case SCENE_GAMEOVER:
+            if ((pressed & KEY_START) && scene_gameover_update(pad) == SCENE_TITLE) {
+                events |= GAME_EV_CONFIRM;
+                set_scene(SCENE_TITLE);
+                scene_title_enter();
+            }
+
+            // Scroll starfield even on game over
+            scroll_starfield();
+            break;
+    }
+
+    hud_update();
+    PROF_BEGIN(PROF_OAM);
+    oam_end();
+    PROF_END(PROF_OAM);
+    xfer_set_bg2_vscroll(g_game.scroll_y);
+
+    g_game.prev_pad = pad;
+    g_game.frame++;
+    return events;
+}
+
+// h = rotl(h, 5) ^ v: cheap on the 65816 and order-sensitive
+#define HASH_MIX(h, v) ((h) = (u16)(((h) << 5) | ((h) >> 11)) ^ (u16)(v))
+
+u16 game_hash(void) {
+    const GameState* g = &g_game;
+    const Bullet* b;
+    u16 h = 0x5EED;
+    u8 i;
+
+    HASH_MIX(h, g->scene);
+    HASH_MIX(h, g->player_x);
+    HASH_MIX(h, g->player_y);
+    HASH_MIX(h, ((u16)g->player_fx << 8) | g->player_fy);
+    HASH_MIX(h, ((u16)g->aim << 8) | g->fire_timer);
+    HASH_MIX(h, g->level);
+    HASH_MIX(h, g->frame);
+    HASH_MIX(h, g->stats.kills.b[0] | ((u16)g->stats.kills.b[1] << 8));
+    HASH_MIX(h, g->stats.kills.b[2]);
+    HASH_MIX(h, g_rng);
+
+    HASH_MIX(h, g_bulletCount);
+    for (i = 0; i < g_bulletCount; i++) {
+        b = &g_bullets[g_bulletLive[i]];
+        HASH_MIX(h, b->x);
+        HASH_MIX(h, b->y);
+        HASH_MIX(h, b->vx);
+        HASH_MIX(h, b->vy);
+        HASH_MIX(h, ((u16)b->fx << 8) | b->fy);
+    }
+
+    HASH_MIX(h, g_enemyCount);
+    for (i = 0; i < g_enemyCount; i++) {
+        HASH_MIX(h, g_enemyX[i]);
+        HASH_MIX(h, g_enemyY[i]);
+        HASH_MIX(h, g_enemyVx[i]);
+        HASH_MIX(h, g_enemyVy[i]);
+        HASH_MIX(h, ((u16)g_enemyFx[i] << 8) | g_enemyFy[i]);
+        HASH_MIX(h, ((u16)g_enemyHp[i] << 8) | g_enemyState[i]);
+        HASH_MIX(h, g_enemyType[i]);
+    }
+
+    HASH_MIX(h, g_ebCount);
+    for (i = 0; i < EBULLET_MAX; i++) {
+        if (!g_ebLive[i]) continue;
+        HASH_MIX(h, i);
+        HASH_MIX(h, g_ebX[i]);
+        HASH_MIX(h, g_ebY[i]);
+        HASH_MIX(h, g_ebVx[i]);
+        HASH_MIX(h, g_ebVy[i]);
+        HASH_MIX(h, ((u16)g_ebFx[i] << 8) | g_ebFy[i]);
+    }
+
+    return h;
+}
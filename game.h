@@ -0,0 +1,73 @@
+#pragma once
+
+#include <snes.h>
+
+#include "bench.h"
+
+// Screen dimensions
+#define SCREEN_W 256
+#define SCREEN_H 224
+
+// Gameplay constants (speeds are 8.8 fixed point pixels per frame)
+#define PLAYER_SPEED 0x0200
+#define BULLET_SPEED 0x0400
+#define ENEMY_SPEED 0x0100
+#define ENEMY_REAIM_FRAMES 4
+#define AUTOFIRE_INTERVAL (BENCH_HAS(BENCH_BULLETS) ? 1 : 6)
+#define PLAYER_SIZE 16
+#define ENEMY_SIZE 16
+#define BULLET_SIZE 8
+// Bullet-enemy broad phase (collide.h): the sprite boxes overlap
+#define BULLET_COLLISION_RADIUS ((BULLET_SIZE + ENEMY_SIZE) / 2)
+// Player-enemy broad phase: top-left corners this close on both axes
+// (the boxes are the same size, so that is an overlap)
+#define PLAYER_COLLISION_RADIUS ((PLAYER_SIZE + ENEMY_SIZE) / 2)
+
+#include "scenes.h"
+
+// Simulation state carried between frames. Entity tables live in their own
+// modules (bullets, enemies, grid); everything else the gameplay step reads
+// or writes is here, so it runs unchanged in the host build (host/).
+typedef struct GameState {
+    s16 player_x, player_y;  // First: kernels.asm reads them at offsets 0 / 2
+    Scene scene;
+    u8 player_fx, player_fy;  // Sub-pixel
+    u8 aim;                   // Last move direction (256-angle)
+    u8 fire_timer;            // Frames until the next autofire shot
+    u16 level;                // Binary copy of stats.level for gameplay scaling
+    u16 kills;                // Binary copy of stats.kills for wave scripts
+    u16 frame;
+    u16 scroll_x, scroll_y;
+    u16 prev_pad;
+    GameStats stats;
+} GameState;
+
+// The ROM keeps g_game at the start of a page-aligned window in bank 0
+// (game_dp.asm). kernels.asm points D at that page and reads the player
+// position with one-byte direct-page operands; its own scratch takes the
+// end of the page, from GAME_DP_SCRATCH, which game.c checks GameState
+// against.
+#define GAME_DP_SIZE 0x100
+#define GAME_DP_SCRATCH 0xF0
+
+extern GameState g_game;
+
+// Events raised by game_step(), for the caller to turn into sound
+#define GAME_EV_CONFIRM     0x01  // Scene change confirmed with START
+#define GAME_EV_SHOT        0x02
+#define GAME_EV_ENEMY_HIT   0x04
+#define GAME_EV_ENEMY_DOWN  0x08
+#define GAME_EV_LEVEL_UP    0x10
+#define GAME_EV_PLAYER_DOWN 0x20
+
+// Enter the title scene with a fresh state
+void game_init(void);
+
+// Run one frame of simulation for the given pad state. Sprites go to the
+// shadow OAM, HUD/text and BG2 scroll to their WRAM shadows; nothing here
+// touches the PPU or APU directly. Returns GAME_EV_* flags.
+u8 game_step(u16 pad);
+
+// Rolling hash of the simulation state (scene, player, counters, RNG and
+// all live bullets/enemies), for comparing runs
+u16 game_hash(void);
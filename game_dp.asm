@@ -0,0 +1,15 @@
+;---------------------------------------------------------------------------
+; Direct-page window for the gameplay state (GameState g_game, game.h)
+;
+; One page of bank 0 WRAM, page aligned so that with D pointing at it every
+; byte is a one-byte direct-page operand with no extra cycle for a non-zero
+; DL. kernels.asm runs with D here: it reads the player position from the
+; state at the start of the page and keeps its scratch at the end, from
+; GAME_DP_SCRATCH. The host build defines g_game in game.c instead.
+;---------------------------------------------------------------------------
+
+.include "hdr.asm"
+
+.RAMSECTION ".game_dp" BANK 0 SLOT 1 ALIGN 256
+g_game      dsb 256     ; GAME_DP_SIZE
+.ENDS
@@ -2,9 +2,42 @@
 
 #include <snes.h>
 
-// Sprite tiles (4bpp)
-extern const u8 g_spriteTiles4bpp[];
-extern const u16 g_spriteTiles4bpp_len;
+#include "oam.h"
+
+// Tiles and palettes converted from gfx/*.png by `make assets`
+// (tools/gfxconv.c) and included by data.asm. Tiles are LZ-compressed for
+// lz_to_vram() (lz.h).
+
+// Sprite tiles (4bpp) are laid out like sprite VRAM, 16 tiles per row, so
+// 16x16 objects use tile N with N+1, N+16 and N+17: player (tile 0), enemy
+// (tile 2), bullet (tile 4). Their palettes are below, one per sprite type.
+extern char gfx_sprites_lz;
+#define GFX_TILE_PLAYER 0
+#define GFX_TILE_ENEMY  2
+#define GFX_TILE_BULLET 4
+
+// 1-bit collision masks cut from the same sheet: one u16 per pixel row,
+// bit 15 = leftmost pixel, for each 16-pixel column (gfx/sprites.mask.inc).
+// GFX_MASK(tile) is the first row of the object whose top-left is that
+// tile. Rows are 16 pixels wide, so the tile must be the left one of a
+// column (even; GFX_MASK_TILE_OK) and the object must end within the sheet:
+// 16x16 objects start in the top tile row, 8x8 ones use the high byte.
+// An odd tile would silently give the column to its left.
+#define GFX_MASK_SHEET_H 16
+#define GFX_MASK_TILE_OK(tile, h) (((tile) & 1) == 0 && ((tile) >> 4) * 8 + (h) <= GFX_MASK_SHEET_H)
+#define GFX_MASK(tile) (&g_spriteMasks[((tile) & 15) / 2 * GFX_MASK_SHEET_H + ((tile) >> 4) * 8])
+extern const u16 g_spriteMasks[];
+
+// Starfield tiles (4bpp) for BG2 and their 16-colour palette
+extern char gfx_starfield_lz;
+extern char gfx_starfield_pal;
+#define GFX_STARFIELD_PAL_SIZE (16 * 2)
+
+// Metasprites (ROM tables of pieces referencing the sprite tiles)
+extern const Metasprite g_msPlayer;
+extern const Metasprite g_msEnemy;
+extern const Metasprite g_msBullet;
+extern const Metasprite g_msEnemyBullet;
 
 // Sprite palettes (one per sprite type to avoid conflicts)
 // Player = palette 0, Enemy = palette 1, Bullet = palette 2
@@ -14,9 +47,3 @@ extern const u16 g_enemyPal[];
 extern const u16 g_enemyPal_len;
 extern const u16 g_bulletPal[];
 extern const u16 g_bulletPal_len;
-
-// BG2 grid tiles (4bpp), palette (16 colors), and map (32x32)
-extern const u8 g_gridTiles4bpp[];
-extern const u16 g_gridTiles4bpp_len;
-extern const u16 g_gridPal16[];
-extern const u16 g_gridPal16_len;
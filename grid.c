@@ -0,0 +1,87 @@
+#include <snes.h>
+
+#include "enemies.h"
+#include "grid.h"
+
+// Per-cell list heads and per-enemy doubly linked membership
+static u8 s_head[GRID_CELLS];
+static u8 s_cell[MAX_ENEMIES];
+static u8 s_prev[MAX_ENEMIES];
+static u8 s_next[MAX_ENEMIES];
+
+u8 grid_cell_of(s16 x, s16 y) {
+    s16 col = x >> GRID_CELL_SHIFT;
+    s16 row = y >> GRID_CELL_SHIFT;
+
+    if (col < 0) col = 0;
+    else if (col >= GRID_W) col = GRID_W - 1;
+    if (row < 0) row = 0;
+    else if (row >= GRID_H) row = GRID_H - 1;
+
+    return (u8)((row << 4) | col);  // GRID_W == 16
+}
+
+void grid_clear(void) {
+    u8 c;
+    for (c = 0; c < GRID_CELLS; c++) {
+        s_head[c] = GRID_NONE;
+    }
+}
+
+void grid_insert(u8 i, u8 cell) {
+    const u8 head = s_head[cell];
+
+    s_cell[i] = cell;
+    s_prev[i] = GRID_NONE;
+    s_next[i] = head;
+    if (head != GRID_NONE) s_prev[head] = i;
+    s_head[cell] = i;
+}
+
+void grid_remove(u8 i) {
+    const u8 prev = s_prev[i];
+    const u8 next = s_next[i];
+
+    if (prev != GRID_NONE) s_next[prev] = next;
+    else s_head[s_cell[i]] = next;
+    if (next != GRID_NONE) s_prev[next] = prev;
+}
+
+void grid_move(u8 i, u8 cell) {
+    if (s_cell[i] == cell) return;
+    grid_remove(i);
+    grid_insert(i, cell);
+}
+
+void grid_renumber(u8 from, u8 to) {
+    const u8 prev = s_prev[from];
+    const u8 next = s_next[from];
+
+    s_cell[to] = s_cell[from];
+    s_prev[to] = prev;
+    s_next[to] = next;
+    if (prev != GRID_NONE) s_next[prev] = to;
+    else s_head[s_cell[from]] = to;
+    if (next != GRID_NONE) s_prev[next] = to;
+}
+
+u8 grid_gather(s16 x, s16 y, u8* out) {
+    const u8 center = grid_cell_of(x, y);
+    const u8 col = center & (GRID_W - 1);
+    const u8 row = center >> 4;
+    const u8 col0 = (col > 0) ? col - 1 : col;
+    const u8 col1 = (col < GRID_W - 1) ? col + 1 : col;
+    const u8 row0 = (row > 0) ? row - 1 : row;
+    const u8 row1 = (row < GRID_H - 1) ? row + 1 : row;
+    u8 n = 0;
+    u8 r, c, i;
+
+    for (r = row0; r <= row1; r++) {
+        for (c = col0; c <= col1; c++) {
+            for (i = s_head[(r << 4) | c]; i != GRID_NONE; i = s_next[i]) {
+                out[n++] = i;
+            }
+        }
+    }
+    return n;
+}
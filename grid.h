@@ -0,0 +1,34 @@
+#ifndef STARSHMUP_GRID_H
+#define STARSHMUP_GRID_H
+
+#include <snes.h>
+
+// Uniform screen-space bucket grid for enemies (broadphase).
+// Cells are 16x16 pixels: no collision reach in the game exceeds 15 pixels
+// between centers, so any colliding pair shares or neighbours a cell.
+#define GRID_CELL_SHIFT 4
+#define GRID_W 16  // 256 / 16
+#define GRID_H 14  // 224 / 16
+#define GRID_CELLS (GRID_W * GRID_H)
+#define GRID_NONE 0xFF
+
+// Largest number of candidates grid_gather() can return
+#define GRID_GATHER_MAX MAX_ENEMIES
+
+// Cell index for a screen-space point, clamped to the playfield
+u8 grid_cell_of(s16 x, s16 y);
+
+void grid_clear(void);
+
+// Membership is kept per enemy index and relinked only when the cell changes.
+void grid_insert(u8 i, u8 cell);
+void grid_remove(u8 i);
+void grid_move(u8 i, u8 cell);
+// Enemy 'from' now lives at index 'to' (after a swap-remove)
+void grid_renumber(u8 from, u8 to);
+
+// Collect enemies in the cell containing (x, y) and its 8 neighbours.
+// Returns the count written to out.
+u8 grid_gather(s16 x, s16 y, u8* out);
+
+#endif
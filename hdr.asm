@@ -12,18 +12,29 @@
 .ROMBANKSIZE $8000              ; Every ROM bank is 32 KBytes in size
 .ROMBANKS 8                     ; 2 Mbits - Tell WLA we want to use 8 ROM Banks
 
+.IFDEF FASTROM                  ; make FASTROM=1 / ./build.sh fast
+.BASE $80                       ; Labels of objects assembled with this file
+.ENDIF                          ; (the game's asm and C) go in the $80-$87
+                                ; mirror; PVSnesLib's prebuilt crt0 and library
+                                ; objects keep their own banks. fastrom.asm
+                                ; moves execution up and sets MEMSEL
+
 .SNESHEADER
   ID "SNES"                     ; 1-4 letter string, just leave it as "SNES"
 
   NAME "STARSHMUP            "  ; Program Title - can't be over 21 bytes,
   ;    "123456789012345678901"  ; use spaces for unused bytes of the name.
 
+.IFDEF FASTROM
+  FASTROM
+.ELSE
   SLOWROM
+.ENDIF
   LOROM
 
-  CARTRIDGETYPE $00             ; $00=ROM, $01=ROM+RAM, $02=ROM+SRAM
+  CARTRIDGETYPE $02             ; $00=ROM, $01=ROM+RAM, $02=ROM+SRAM
   ROMSIZE $08                   ; $08=2 Megabits
-  SRAMSIZE $00                  ; $00=0 kilobits
+  SRAMSIZE $03                  ; $00=0 kilobits, $03=64 kilobits (input recording, replay.h)
   COUNTRY $01                   ; $01= U.S.
   LICENSEECODE $00              ; Just use $00
   VERSION $00                   ; $00 = 1.00
@@ -0,0 +1,44 @@
+# Native build of the gameplay simulation (see host/host_main.c).
+# Included by the top-level Makefile for the host goals; needs only a C
+# compiler, not PVSnesLib.
+
+HOST_CC ?= cc
+HOST_CFLAGS ?= -O2 -g -Wall
+HOST_BIN := host/starshmup_host
+
+# Everything but main.c (hardware init and the VBlank loop)
+HOST_SRC := arena.c bcd.c bullets.c collide.c ebullets.c enemies.c game.c gfx.c grid.c hud.c hwmath.c jobs.c \
+            oam.c rng.c scene_gameover.c scene_title.c trig.c waves.c wave_scripts.c xfer.c \
+            host/host_main.c host/snes_stub.c
+
+HOST_DEFS := -DHOST_BUILD
+ifeq ($(COLLIDE_BRUTE_FORCE),1)
+HOST_DEFS += -DCOLLIDE_BRUTE_FORCE
+endif
+ifeq ($(OAM_LINE_STATS),1)
+HOST_DEFS += -DOAM_LINE_STATS
+endif
+
+# ASM_KERNELS=1 runs kernels.asm on the 65816 simulator (host/sim65.h) in
+# place of the C versions; KERNEL_CHECK=1 first compares the two as the ROM
+# does (kcheck.h). Run `make host-clean` when switching.
+ifneq (,$(filter 1,$(ASM_KERNELS) $(KERNEL_CHECK)))
+HOST_SRC += kcheck.c host/sim65.c host/kernels_host.c
+endif
+ifeq ($(ASM_KERNELS),1)
+HOST_DEFS += -DASM_KERNELS
+endif
+ifeq ($(KERNEL_CHECK),1)
+HOST_DEFS += -DKERNEL_CHECK
+endif
+
+.PHONY: host host-clean
+
+host: $(HOST_BIN)
+
+# host/ comes first so <snes.h> resolves to the stub
+$(HOST_BIN): $(HOST_SRC) $(wildcard *.h) $(wildcard host/*.h) gfx/sprites.mask.inc
+	$(HOST_CC) $(HOST_CFLAGS) $(HOST_DEFS) -Ihost -I. -o $@ $(HOST_SRC)
+
+host-clean:
+	rm -f $(HOST_BIN)
@@ -0,0 +1,357 @@
+// Headless driver for the gameplay simulation.
+//
+// Runs game_step() for a scripted or pseudo-random pad stream as fast as
+// the host allows and reports per-section timing (see prof.h), event
+// counts and state hashes. Hashes are deterministic for a given input
+// stream and seed, so two builds can be compared at fixed intervals (-k).
+//
+//   starshmup_host [-n frames] [-s seed] [-i script | -r recording] [-k interval]
+//
+// A script is a list of "<frames> [BUTTON ...]" lines (UP DOWN LEFT RIGHT
+// START SELECT A B X Y L R; '#' starts a comment) and loops until the frame
+// count is reached. Without one, random d-pad directions are held for
+// 8-63 frames and START toggles every frame, so the title and game over
+// screens are left as soon as they appear.
+//
+// -r replays an input recording from an SRAM dump of a normal ROM (format
+// in replay.h) with its own seed, for as many frames as it holds unless -n
+// says otherwise. With -k 600 the hashes line up with a REPLAY ROM's
+// g_replay.hashes.
+//
+// Built with ASM_KERNELS or KERNEL_CHECK (host.mk), the asm kernels run on
+// a 65816 simulator; -a picks the source to assemble. KERNEL_CHECK builds
+// run kcheck_run() before the game, print its result and exit with 1 if
+// the kernels and their C references disagreed. ASM_KERNELS builds report
+// what the kernel calls cost in CPU cycles, per call and per frame, and in
+// master cycles per frame with the code in SlowROM and in FastROM.
+
+#include <snes.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "arena.h"
+#include "bullets.h"
+#include "enemies.h"
+#include "game.h"
+#include "jobs.h"
+#include "kcheck.h"
+#include "oam.h"
+#include "prof.h"
+#include "replay.h"
+#include "rng.h"
+#include "waves.h"
+#include "xfer.h"
+
+#if defined(ASM_KERNELS) || defined(KERNEL_CHECK)
+#include "kernels_host.h"
+#endif
+
+#define SCRIPT_MAX 4096
+
+typedef struct ScriptStep {
+    u32 frames;
+    u16 pad;
+} ScriptStep;
+
+static const char* const s_sectionNames[PROF_SECTION_COUNT] = {
+    "player", "enemies", "bullets", "waves", "ebullets", "collide", "oam",
+    "game_step", "sfx", "jobs", "oam_dma", "xfer",
+};
+
+static const struct {
+    const char* name;
+    u16 bit;
+} s_buttons[] = {
+    { "UP", KEY_UP }, { "DOWN", KEY_DOWN }, { "LEFT", KEY_LEFT }, { "RIGHT", KEY_RIGHT },
+    { "START", KEY_START }, { "SELECT", KEY_SELECT }, { "A", KEY_A }, { "B", KEY_B },
+    { "X", KEY_X }, { "Y", KEY_Y }, { "L", KEY_L }, { "R", KEY_R },
+};
+
+static const u16 s_directions[8] = {
+    KEY_UP, KEY_UP | KEY_RIGHT, KEY_RIGHT, KEY_DOWN | KEY_RIGHT,
+    KEY_DOWN, KEY_DOWN | KEY_LEFT, KEY_LEFT, KEY_UP | KEY_LEFT,
+};
+
+static ScriptStep s_script[SCRIPT_MAX];
+static u32 s_scriptLen;
+
+static uint64_t s_sectionStart[PROF_SECTION_COUNT];
+static uint64_t s_sectionNs[PROF_SECTION_COUNT];
+static uint64_t s_sectionMaxNs[PROF_SECTION_COUNT];  // Slowest single call
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void host_prof_begin(u8 section) {
+    s_sectionStart[section] = now_ns();
+}
+
+void host_prof_end(u8 section) {
+    uint64_t ns = now_ns() - s_sectionStart[section];
+    s_sectionNs[section] += ns;
+    if (ns > s_sectionMaxNs[section]) s_sectionMaxNs[section] = ns;
+}
+
+static u16 parse_button(const char* tok, const char* path, u32 line) {
+    u32 i;
+
+    for (i = 0; i < sizeof(s_buttons) / sizeof(s_buttons[0]); i++) {
+        if (strcmp(tok, s_buttons[i].name) == 0) return s_buttons[i].bit;
+    }
+    fprintf(stderr, "%s:%u: unknown button '%s'\n", path, line, tok);
+    exit(1);
+}
+
+static void load_script(const char* path) {
+    char buf[256];
+    char* tok;
+    FILE* f;
+    u32 line = 0;
+    ScriptStep* st;
+
+    f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        exit(1);
+    }
+    while (fgets(buf, sizeof(buf), f)) {
+        line++;
+        if ((tok = strchr(buf, '#')) != NULL) *tok = '\0';
+        tok = strtok(buf, " \t\r\n");
+        if (!tok) continue;
+        if (s_scriptLen == SCRIPT_MAX) {
+            fprintf(stderr, "%s: more than %d steps\n", path, SCRIPT_MAX);
+            exit(1);
+        }
+        st = &s_script[s_scriptLen++];
+        st->frames = (u32)strtoul(tok, NULL, 10);
+        st->pad = 0;
+        if (st->frames == 0) {
+            fprintf(stderr, "%s:%u: frame count must be positive\n", path, line);
+            exit(1);
+        }
+        while ((tok = strtok(NULL, " \t\r\n")) != NULL) {
+            st->pad |= parse_button(tok, path, line);
+        }
+    }
+    fclose(f);
+    if (s_scriptLen == 0) {
+        fprintf(stderr, "%s: empty script\n", path);
+        exit(1);
+    }
+}
+
+// Turn an SRAM recording into script steps and return its frame count.
+// The recorded seed goes to *seed.
+static u32 load_replay(const char* path, u16* seed) {
+    static u8 image[REPLAY_BYTES];
+    FILE* f;
+    size_t size;
+    u32 runs, i, total = 0;
+    const u8* run;
+
+    f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        exit(1);
+    }
+    size = fread(image, 1, sizeof(image), f);
+    fclose(f);
+
+    runs = size >= REPLAY_HEADER ? image[6] | ((u32)image[7] << 8) : 0;
+    if (size < REPLAY_HEADER || memcmp(image, "RPLY", 4) != 0 || runs > REPLAY_MAX_RUNS ||
+        size < REPLAY_HEADER + runs * REPLAY_RUN) {
+        fprintf(stderr, "%s: not an input recording\n", path);
+        exit(1);
+    }
+    if (runs == 0) {
+        fprintf(stderr, "%s: empty recording\n", path);
+        exit(1);
+    }
+
+    *seed = (u16)(image[4] | (image[5] << 8));
+    for (i = 0; i < runs; i++) {
+        run = &image[REPLAY_HEADER + i * REPLAY_RUN];
+        s_script[i].pad = (u16)(run[0] | (run[1] << 8));
+        s_script[i].frames = run[2];
+        total += run[2];
+    }
+    s_scriptLen = runs;
+    return total;
+}
+
+// xorshift32 for the random pad stream, separate from the game's g_rng
+static u32 s_padRng;
+
+static u32 pad_rng_next(void) {
+    s_padRng ^= s_padRng << 13;
+    s_padRng ^= s_padRng >> 17;
+    s_padRng ^= s_padRng << 5;
+    return s_padRng;
+}
+
+static u16 next_pad(u32 frame) {
+    static u32 step, left;
+    static u16 held;
+    u32 r;
+
+    if (s_scriptLen) {
+        if (left == 0) {
+            held = s_script[step].pad;
+            left = s_script[step].frames;
+            step = (step + 1) % s_scriptLen;
+        }
+        left--;
+        return held;
+    }
+
+    if (left == 0) {
+        r = pad_rng_next();
+        held = s_directions[r & 7];
+        left = 8 + ((r >> 3) & 55);
+    }
+    left--;
+    return held | ((frame & 1) ? KEY_START : 0);
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [-n frames] [-s seed] [-i script | -r recording] [-k hash_interval]"
+#if defined(ASM_KERNELS) || defined(KERNEL_CHECK)
+                    " [-a kernels.asm]"
+#endif
+                    "\n",
+            argv0);
+    exit(1);
+}
+
+#ifdef ASM_KERNELS
+// CPU cycles per call, then CPU and master cycles per frame
+static void print_kernel(const char* name, const HostKernelStats* k, u32 frames) {
+    const double calls = k->calls ? (double)k->calls : 1.0;
+    const double per_frame = frames ? (double)frames : 1.0;
+
+    printf("%-24s %10llu %9.1f %9.1f %11.1f %11.1f\n", name, (unsigned long long)k->calls,
+           k->sim.cycles / calls, k->sim.cycles / per_frame, k->sim.master_slow / per_frame,
+           k->sim.master_fast / per_frame);
+}
+#endif
+
+int main(int argc, char** argv) {
+    u32 frames = 1000000;
+    u32 seed = 0;
+    u32 hash_every = 0;
+    u32 frame, i;
+    u32 games = 0, gameplay_frames = 0, shots = 0, kills = 0;
+    u32 peak_bullets = 0, peak_enemies = 0;
+    u32 oam_drop_frames = 0, oam_drop_peak = 0;
+    u16 level_max = 0;
+    uint64_t total_ns;
+    u32 replay_frames = 0;
+    u16 replay_seed = 0;
+    u8 frames_set = 0;
+    u8 events;
+
+    for (i = 1; i < (u32)argc; i++) {
+        if (i + 1 == (u32)argc) usage(argv[0]);
+        if (strcmp(argv[i], "-n") == 0) {
+            frames = (u32)strtoul(argv[++i], NULL, 0);
+            frames_set = 1;
+        }
+        else if (strcmp(argv[i], "-s") == 0) seed = (u32)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "-i") == 0) load_script(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0) replay_frames = load_replay(argv[++i], &replay_seed);
+        else if (strcmp(argv[i], "-k") == 0) hash_every = (u32)strtoul(argv[++i], NULL, 0);
+#if defined(ASM_KERNELS) || defined(KERNEL_CHECK)
+        else if (strcmp(argv[i], "-a") == 0) g_hostKernelsPath = argv[++i];
+#endif
+        else usage(argv[0]);
+    }
+
+    // Seed 0 keeps the ROM's power-on g_rng; neither generator may be zero
+    s_padRng = seed ? seed : 0x2545F491u;
+    if ((u16)seed) g_rng = (u16)seed;
+    if (replay_frames) {
+        g_rng = replay_seed;
+        if (!frames_set) frames = replay_frames;
+    }
+
+    xfer_init();
+#ifdef KERNEL_CHECK
+    kcheck_run();
+    printf("kcheck:   %u rounds, %u bullet step, %u collision scan and %u player scan "
+           "mismatches\n",
+           g_kernelCheck.rounds, g_kernelCheck.bullet_fails, g_kernelCheck.collide_fails,
+           g_kernelCheck.player_fails);
+    if (g_kernelCheck.bullet_fails || g_kernelCheck.collide_fails || g_kernelCheck.player_fails)
+        return 1;
+#endif
+    game_init();
+
+    total_ns = now_ns();
+    for (frame = 0; frame < frames; frame++) {
+        const u16 pad = next_pad(frame);
+
+        PROF_BEGIN(PROF_GAME_STEP);
+        events = game_step(pad);
+        PROF_END(PROF_GAME_STEP);
+        PROF_BEGIN(PROF_JOBS);
+        jobs_run(0);
+        PROF_END(PROF_JOBS);
+        PROF_BEGIN(PROF_XFER);
+        xfer_vblank();
+        PROF_END(PROF_XFER);
+
+        if (g_game.scene == SCENE_GAMEPLAY) {
+            gameplay_frames++;
+            if (g_game.frame == 1) games++;
+            if (g_bulletCount > peak_bullets) peak_bullets = g_bulletCount;
+            if (g_enemyCount > peak_enemies) peak_enemies = g_enemyCount;
+            if (g_game.level > level_max) level_max = g_game.level;
+        }
+        if (g_oamDropped) {
+            oam_drop_frames++;
+            if (g_oamDropped > oam_drop_peak) oam_drop_peak = g_oamDropped;
+        }
+        if (events & GAME_EV_SHOT) shots++;
+        if (events & GAME_EV_ENEMY_DOWN) kills++;
+
+        if (hash_every && (frame + 1) % hash_every == 0) {
+            printf("hash @%u: %04x\n", frame + 1, game_hash());
+        }
+    }
+    total_ns = now_ns() - total_ns;
+
+    printf("frames:   %u (%u in gameplay, %u games)\n", frames, gameplay_frames, games);
+    printf("wall:     %.3f s, %.0f frames/s\n", total_ns / 1e9,
+           total_ns ? frames / (total_ns / 1e9) : 0.0);
+    printf("events:   %u shots, %u kill frames\n", shots, kills);
+    printf("peaks:    %u bullets, %u enemies, level %u, %u wave ops\n", peak_bullets,
+           peak_enemies, level_max, g_waveOpsPeak);
+    printf("oam:      %u frames over %u objects, up to %u left out\n", oam_drop_frames,
+           OAM_SLOTS - OAM_PRIORITY_SLOTS, oam_drop_peak);
+    printf("arena:    %u title, %u gameplay, %u gameover bytes peak of %u\n",
+           g_arenaPeak[SCENE_TITLE], g_arenaPeak[SCENE_GAMEPLAY], g_arenaPeak[SCENE_GAMEOVER],
+           ARENA_BYTES);
+    printf("\n%-10s %12s %10s %10s\n", "section", "total ms", "ns/frame", "max ns");
+    for (i = 0; i < PROF_SECTION_COUNT; i++) {
+        if (!s_sectionNs[i]) continue;  // Hardware-only sections (sfx, oam_dma)
+        printf("%-10s %12.2f %10.1f %10u\n", s_sectionNames[i], s_sectionNs[i] / 1e6,
+               frames ? (double)s_sectionNs[i] / frames : 0.0, (u32)s_sectionMaxNs[i]);
+    }
+#ifdef ASM_KERNELS
+    printf("\n%-24s %10s %9s %9s %11s %11s\n", "kernel", "calls", "cyc/call", "cyc/frame",
+           "slow/frame", "fast/frame");
+    print_kernel("bullets_step_asm", &g_hostBulletsStep, frames);
+    print_kernel("collide_scan_asm", &g_hostCollideScan, frames);
+    print_kernel("collide_player_scan_asm", &g_hostPlayerScan, frames);
+#endif
+    printf("\nfinal hash: %04x\n", game_hash());
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <snes.h>
+
+#include "bullets.h"
+#include "collide.h"
+#include "enemies.h"
+#include "game.h"
+#include "kernels_host.h"
+
+const char* g_hostKernelsPath = "kernels.asm";
+
+HostKernelStats g_hostBulletsStep;
+HostKernelStats g_hostCollideScan;
+HostKernelStats g_hostPlayerScan;
+
+// Simulated addresses of the C globals the kernels use: 816-tcc places
+// globals in bank $7E from $2000, and its registers in the direct page.
+// g_game gets a page of bank 0, as game_dp.asm gives it in the ROM.
+#define SIM_GLOBALS 0x7E2000u
+#define SIM_TCC_R0 0x000000u
+#define SIM_GAME 0x000200u
+
+static u32 s_bullets, s_bulletLive, s_bulletFree, s_bulletCount, s_bulletFreeCount;
+static u32 s_enemyX, s_enemyY, s_collideList;
+static u8 s_loaded;
+
+static u32 place(const char* name, u32 size) {
+    static u32 next = SIM_GLOBALS;
+    const u32 at = next;
+
+    sim65_define(name, at);
+    next += size;
+    return at;
+}
+
+static void load(void) {
+    if (s_loaded) return;
+    s_bullets = place("g_bullets", MAX_BULLETS * 10);
+    s_bulletLive = place("g_bulletLive", MAX_BULLETS);
+    s_bulletFree = place("g_bulletFree", MAX_BULLETS);
+    s_bulletCount = place("g_bulletCount", 1);
+    s_bulletFreeCount = place("g_bulletFreeCount", 1);
+    s_enemyX = place("g_enemyX", MAX_ENEMIES * 2);
+    s_enemyY = place("g_enemyY", MAX_ENEMIES * 2);
+    s_collideList = place("g_collideList", MAX_ENEMIES);
+    sim65_define("tcc__r0", SIM_TCC_R0);
+    sim65_define("g_game", SIM_GAME);
+    sim65_load(g_hostKernelsPath);
+    s_loaded = 1;
+}
+
+static void put16(u32 addr, u16 v) {
+    u8* m = sim65_mem(addr);
+
+    m[0] = (u8)v;
+    m[1] = (u8)(v >> 8);
+}
+
+static u16 get16(u32 addr) {
+    const u8* m = sim65_mem(addr);
+
+    return (u16)(m[0] | (m[1] << 8));
+}
+
+static void put_bytes(u32 addr, const u8* src, u32 size) {
+    while (size--) *sim65_mem(addr++) = *src++;
+}
+
+static void get_bytes(u32 addr, u8* dst, u32 size) {
+    while (size--) *dst++ = *sim65_mem(addr++);
+}
+
+// Run a kernel and add its cost to *stats
+static void call(const char* label, const u16* args, u8 nargs, HostKernelStats* stats) {
+    const Sim65Stats before = g_sim65;
+
+    sim65_call(label, args, nargs);
+    stats->calls++;
+    stats->sim.instructions += g_sim65.instructions - before.instructions;
+    stats->sim.cycles += g_sim65.cycles - before.cycles;
+    stats->sim.master_slow += g_sim65.master_slow - before.master_slow;
+    stats->sim.master_fast += g_sim65.master_fast - before.master_fast;
+}
+
+// struct Bullet as 816-tcc lays it out: four words, then two bytes
+void bullets_step_asm(void) {
+    u32 at;
+    u8 i;
+
+    load();
+    for (i = 0; i < MAX_BULLETS; i++) {
+        at = s_bullets + i * 10;
+        put16(at + 0, (u16)g_bullets[i].x);
+        put16(at + 2, (u16)g_bullets[i].y);
+        put16(at + 4, (u16)g_bullets[i].vx);
+        put16(at + 6, (u16)g_bullets[i].vy);
+        *sim65_mem(at + 8) = g_bullets[i].fx;
+        *sim65_mem(at + 9) = g_bullets[i].fy;
+    }
+    put_bytes(s_bulletLive, g_bulletLive, MAX_BULLETS);
+    put_bytes(s_bulletFree, g_bulletFree, MAX_BULLETS);
+    *sim65_mem(s_bulletCount) = g_bulletCount;
+    *sim65_mem(s_bulletFreeCount) = g_bulletFreeCount;
+
+    call("bullets_step_asm", 0, 0, &g_hostBulletsStep);
+
+    for (i = 0; i < MAX_BULLETS; i++) {
+        at = s_bullets + i * 10;
+        g_bullets[i].x = (s16)get16(at + 0);
+        g_bullets[i].y = (s16)get16(at + 2);
+        g_bullets[i].vx = (s16)get16(at + 4);
+        g_bullets[i].vy = (s16)get16(at + 6);
+        g_bullets[i].fx = *sim65_mem(at + 8);
+        g_bullets[i].fy = *sim65_mem(at + 9);
+    }
+    get_bytes(s_bulletLive, g_bulletLive, MAX_BULLETS);
+    get_bytes(s_bulletFree, g_bulletFree, MAX_BULLETS);
+    g_bulletCount = *sim65_mem(s_bulletCount);
+    g_bulletFreeCount = *sim65_mem(s_bulletFreeCount);
+}
+
+static void put_enemies(void) {
+    u8 i;
+
+    for (i = 0; i < MAX_ENEMIES; i++) {
+        put16(s_enemyX + i * 2, (u16)g_enemyX[i]);
+        put16(s_enemyY + i * 2, (u16)g_enemyY[i]);
+    }
+    put_bytes(s_collideList, g_collideList, MAX_ENEMIES);
+}
+
+u8 collide_scan_asm(s16 bx, s16 by, u16 first, u16 n) {
+    u16 args[4];
+
+    load();
+    put_enemies();
+
+    args[0] = (u16)bx;
+    args[1] = (u16)by;
+    args[2] = first;
+    args[3] = n;
+    call("collide_scan_asm", args, 4, &g_hostCollideScan);
+
+    return *sim65_mem(SIM_TCC_R0);
+}
+
+// Only the fields kernels.asm reads go into the window (game.h)
+u8 collide_player_scan_asm(u16 first, u16 n) {
+    u16 args[2];
+
+    load();
+    put_enemies();
+    put16(SIM_GAME + 0, (u16)g_game.player_x);
+    put16(SIM_GAME + 2, (u16)g_game.player_y);
+
+    args[0] = first;
+    args[1] = n;
+    call("collide_player_scan_asm", args, 2, &g_hostPlayerScan);
+
+    return *sim65_mem(SIM_TCC_R0);
+}
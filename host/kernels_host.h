@@ -0,0 +1,28 @@
+#ifndef STARSHMUP_HOST_KERNELS_HOST_H
+#define STARSHMUP_HOST_KERNELS_HOST_H
+
+// ASM_KERNELS and KERNEL_CHECK host builds: bullets_step_asm(),
+// collide_scan_asm() and collide_player_scan_asm() run the routines in
+// kernels.asm on the 65816 simulator (sim65.h). Each call copies the C
+// globals the routine reads into simulated WRAM and copies back what it
+// may have written.
+
+#include <snes.h>
+
+#include "sim65.h"
+
+// Source to assemble on first use (-a); kernels.asm in the current
+// directory by default
+extern const char* g_hostKernelsPath;
+
+// What the calls to each kernel have cost so far
+typedef struct HostKernelStats {
+    uint64_t calls;
+    Sim65Stats sim;
+} HostKernelStats;
+
+extern HostKernelStats g_hostBulletsStep;
+extern HostKernelStats g_hostCollideScan;
+extern HostKernelStats g_hostPlayerScan;
+
+#endif
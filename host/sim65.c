@@ -0,0 +1,1167 @@
+// 65816 assembler subset and interpreter for the host build (see sim65.h)
+
+#include "sim65.h"
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define MAX_LINES 8192
+#define MAX_SYMBOLS 1024
+#define MAX_MACROS 32
+#define MAX_MACRO_ARGS 8
+#define MAX_INSTS 4096
+#define LINE_MAX 256
+#define NAME_MAX 64
+
+#define CODE_BANK 0x01
+#define CODE_BASE 0x8000
+#define RETURN_SENTINEL 0xFFFFFFu  // Return address pushed by sim65_call()
+#define STEP_LIMIT 10000000u       // Instructions per call before giving up
+
+Sim65Stats g_sim65;
+
+// --- Source -----------------------------------------------------------------
+
+typedef struct Line {
+    char text[LINE_MAX];
+    const char* file;
+    u16 num;
+} Line;
+
+typedef struct Macro {
+    char name[NAME_MAX];
+    char args[MAX_MACRO_ARGS][NAME_MAX];
+    u8 nargs;
+    u16 first, count;  // Body lines in s_macroLines
+} Macro;
+
+static Line s_lines[MAX_LINES];
+static u16 s_lineCount;
+static Line s_macroLines[MAX_LINES];
+static u16 s_macroLineCount;
+static Macro s_macros[MAX_MACROS];
+static u8 s_macroCount;
+static u16 s_expansions;  // For \@
+
+static const Line* s_at;  // Line being assembled, for messages
+
+static void fail(const char* fmt, ...) {
+    va_list ap;
+
+    if (s_at) fprintf(stderr, "%s:%u: ", s_at->file, s_at->num);
+    else fprintf(stderr, "sim65: ");
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    fputc('\n', stderr);
+    exit(1);
+}
+
+static const char* skip_space(const char* p) {
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+static int is_ident_start(char c) {
+    return isalpha((unsigned char)c) || c == '_';
+}
+
+static int is_ident(char c) {
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+// Copy the identifier at p into out; returns the character after it
+static const char* read_ident(const char* p, char* out) {
+    u32 n = 0;
+
+    while (is_ident(*p)) {
+        if (n + 1 < NAME_MAX) out[n++] = *p;
+        p++;
+    }
+    out[n] = '\0';
+    return p;
+}
+
+// Bounded copy; lines and names longer than the buffers are cut short
+static void copy_text(char* dst, size_t size, const char* src) {
+    size_t n = 0;
+
+    while (src[n] && n + 1 < size) {
+        dst[n] = src[n];
+        n++;
+    }
+    dst[n] = '\0';
+}
+
+static void add_line(Line* lines, u16* count, const char* text, const char* file, u16 num) {
+    Line* l;
+
+    if (*count == MAX_LINES) fail("more than %d lines", MAX_LINES);
+    l = &lines[(*count)++];
+    copy_text(l->text, sizeof(l->text), text);
+    l->file = file;
+    l->num = num;
+}
+
+static Macro* find_macro(const char* name) {
+    u8 i;
+
+    for (i = 0; i < s_macroCount; i++) {
+        if (strcmp(s_macros[i].name, name) == 0) return &s_macros[i];
+    }
+    return NULL;
+}
+
+// Body line with argument names, \1..\9 and \@ replaced
+static void expand_line(const Macro* m, const Line* body, char args[][LINE_MAX], u8 nargs,
+                        char* out) {
+    const char* p = body->text;
+    char name[NAME_MAX];
+    u32 n = 0;
+    u8 i;
+    const char* rep;
+
+    while (*p && n + 1 < LINE_MAX) {
+        rep = NULL;
+        if (*p == '\\' && p[1] == '@') {
+            n += snprintf(out + n, LINE_MAX - n, "%u", s_expansions);
+            p += 2;
+            continue;
+        }
+        if (*p == '\\' && p[1] >= '1' && p[1] <= '9') {
+            i = (u8)(p[1] - '1');
+            if (i >= nargs) fail("macro %s: no argument \\%c", m->name, p[1]);
+            rep = args[i];
+            p += 2;
+        } else if (is_ident_start(*p) && (p == body->text || !is_ident(p[-1]))) {
+            const char* end = read_ident(p, name);
+            for (i = 0; i < m->nargs; i++) {
+                if (strcmp(m->args[i], name) == 0) break;
+            }
+            if (i < m->nargs) {
+                if (i >= nargs) fail("macro %s: missing argument %s", m->name, name);
+                rep = args[i];
+            } else {
+                rep = name;
+            }
+            p = end;
+        }
+        if (rep) {
+            n += snprintf(out + n, LINE_MAX - n, "%s", rep);
+        } else {
+            out[n++] = *p++;
+        }
+    }
+    out[n < LINE_MAX ? n : LINE_MAX - 1] = '\0';
+}
+
+static void strip_comment(char* s) {
+    char* p = s;
+    int quoted = 0;
+
+    for (; *p; p++) {
+        if (*p == '"') quoted = !quoted;
+        if (*p == ';' && !quoted) {
+            *p = '\0';
+            break;
+        }
+    }
+    // Trailing blanks
+    while (p > s && isspace((unsigned char)p[-1])) *--p = '\0';
+}
+
+// Read the file, record macros and expand their uses into s_lines
+static void preprocess(const char* path) {
+    static char text[MAX_LINES][LINE_MAX];
+    char* file_name;
+    FILE* f;
+    u16 count = 0, i;
+    Macro* m = NULL;
+    Line src;
+
+    f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        exit(1);
+    }
+    while (count < MAX_LINES && fgets(text[count], LINE_MAX, f)) {
+        strip_comment(text[count]);
+        count++;
+    }
+    fclose(f);
+    file_name = (char*)malloc(strlen(path) + 1);
+    strcpy(file_name, path);
+
+    s_at = &src;
+    src.file = file_name;
+    for (i = 0; i < count; i++) {
+        const char* p = skip_space(text[i]);
+        char word[NAME_MAX];
+        Macro* use;
+
+        src.num = (u16)(i + 1);
+        copy_text(src.text, sizeof(src.text), p);
+
+        if (m) {
+            if (strncasecmp(p, ".ENDM", 5) == 0) {
+                m = NULL;
+            } else {
+                add_line(s_macroLines, &s_macroLineCount, p, file_name, src.num);
+                m->count++;
+            }
+            continue;
+        }
+        if (strncasecmp(p, ".MACRO", 6) == 0) {
+            if (s_macroCount == MAX_MACROS) fail("too many macros");
+            m = &s_macros[s_macroCount++];
+            p = read_ident(skip_space(p + 6), m->name);
+            p = skip_space(p);
+            m->nargs = 0;
+            m->first = s_macroLineCount;
+            m->count = 0;
+            if (strncasecmp(p, "ARGS", 4) == 0) {
+                p = skip_space(p + 4);
+                while (is_ident_start(*p)) {
+                    if (m->nargs == MAX_MACRO_ARGS) fail("too many macro arguments");
+                    p = skip_space(read_ident(p, m->args[m->nargs++]));
+                    if (*p == ',') p = skip_space(p + 1);
+                }
+            }
+            continue;
+        }
+        if (strncasecmp(p, ".include", 8) == 0) continue;  // hdr.asm: ROM layout only
+
+        read_ident(p, word);
+        use = word[0] ? find_macro(word) : NULL;
+        if (use) {
+            char args[MAX_MACRO_ARGS][LINE_MAX];
+            char out[LINE_MAX];
+            u8 nargs = 0;
+            u16 j;
+
+            p = skip_space(p + strlen(word));
+            while (*p) {
+                u32 n = 0;
+                if (nargs == MAX_MACRO_ARGS) fail("too many macro arguments");
+                while (*p && *p != ',' && n + 1 < LINE_MAX) args[nargs][n++] = *p++;
+                while (n && isspace((unsigned char)args[nargs][n - 1])) n--;
+                args[nargs++][n] = '\0';
+                if (*p == ',') p = skip_space(p + 1);
+            }
+            for (j = 0; j < use->count; j++) {
+                expand_line(use, &s_macroLines[use->first + j], args, nargs, out);
+                add_line(s_lines, &s_lineCount, out, file_name, src.num);
+            }
+            s_expansions++;
+            continue;
+        }
+        add_line(s_lines, &s_lineCount, p, file_name, src.num);
+    }
+    if (m) fail("macro %s has no .ENDM", m->name);
+    s_at = NULL;
+}
+
+// --- Symbols and expressions ------------------------------------------------
+
+enum { SYM_NUMBER, SYM_ADDRESS };
+
+typedef struct Symbol {
+    char name[NAME_MAX];
+    u32 value;
+    u8 kind;
+} Symbol;
+
+static Symbol s_symbols[MAX_SYMBOLS];
+static u16 s_symbolCount;
+
+static Symbol* find_symbol(const char* name) {
+    u16 i;
+
+    for (i = 0; i < s_symbolCount; i++) {
+        if (strcmp(s_symbols[i].name, name) == 0) return &s_symbols[i];
+    }
+    return NULL;
+}
+
+static void set_symbol(const char* name, u32 value, u8 kind) {
+    Symbol* s = find_symbol(name);
+
+    if (s) fail("%s defined twice", name);
+    if (s_symbolCount == MAX_SYMBOLS) fail("too many symbols");
+    s = &s_symbols[s_symbolCount++];
+    copy_text(s->name, sizeof(s->name), name);
+    s->value = value;
+    s->kind = kind;
+}
+
+void sim65_define(const char* name, u32 addr) {
+    set_symbol(name, addr, SYM_ADDRESS);
+}
+
+u32 sim65_symbol(const char* name) {
+    const Symbol* s = find_symbol(name);
+
+    if (!s) fail("no symbol %s", name);
+    return s->value;
+}
+
+typedef struct Expr {
+    const char* p;
+    u8 resolve;  // Unknown names are an error (second pass)
+    u8 address;  // Uses a label or C symbol, not just numbers
+} Expr;
+
+static s32 expr_sum(Expr* e);
+
+static s32 expr_atom(Expr* e) {
+    char name[NAME_MAX];
+    const Symbol* s;
+    s32 v = 0;
+    u8 bank = 0;
+
+    e->p = skip_space(e->p);
+    if (*e->p == '(') {
+        e->p++;
+        v = expr_sum(e);
+        e->p = skip_space(e->p);
+        if (*e->p != ')') fail("missing ')'");
+        e->p++;
+        return v;
+    }
+    if (*e->p == '-') {
+        e->p++;
+        return -expr_atom(e);
+    }
+    if (*e->p == '$') {
+        e->p++;
+        if (!isxdigit((unsigned char)*e->p)) fail("bad hex number");
+        return (s32)strtoul(e->p, (char**)&e->p, 16);
+    }
+    if (*e->p == '%') {
+        e->p++;
+        return (s32)strtoul(e->p, (char**)&e->p, 2);
+    }
+    if (isdigit((unsigned char)*e->p)) return (s32)strtoul(e->p, (char**)&e->p, 10);
+    if (*e->p == ':') {
+        bank = 1;
+        e->p++;
+    }
+    if (!is_ident_start(*e->p)) fail("bad expression at '%s'", e->p);
+    e->p = read_ident(e->p, name);
+    s = find_symbol(name);
+    if (!s) {
+        if (e->resolve) fail("unknown symbol %s", name);
+        e->address = 1;  // A label further down
+        return 0;
+    }
+    if (s->kind == SYM_ADDRESS) e->address = 1;
+    return bank ? (s32)((s->value >> 16) & 0xFF) : (s32)s->value;
+}
+
+static s32 expr_product(Expr* e) {
+    s32 v = expr_atom(e);
+    s32 r;
+
+    for (;;) {
+        e->p = skip_space(e->p);
+        if (*e->p == '*') {
+            e->p++;
+            v *= expr_atom(e);
+        } else if (*e->p == '/') {
+            e->p++;
+            r = expr_atom(e);
+            if (!r) fail("division by zero");
+            v /= r;
+        } else {
+            return v;
+        }
+    }
+}
+
+static s32 expr_sum(Expr* e) {
+    s32 v = expr_product(e);
+
+    for (;;) {
+        e->p = skip_space(e->p);
+        if (*e->p == '+') {
+            e->p++;
+            v += expr_product(e);
+        } else if (*e->p == '-') {
+            e->p++;
+            v -= expr_product(e);
+        } else if (*e->p == '&') {
+            e->p++;
+            v &= expr_product(e);
+        } else if (*e->p == '|') {
+            e->p++;
+            v |= expr_product(e);
+        } else if (e->p[0] == '<' && e->p[1] == '<') {
+            e->p += 2;
+            v <<= expr_product(e);
+        } else if (e->p[0] == '>' && e->p[1] == '>') {
+            e->p += 2;
+            v >>= expr_product(e);
+        } else {
+            return v;
+        }
+    }
+}
+
+static s32 eval(const char* text, u8 resolve, u8* address) {
+    Expr e;
+    s32 v;
+
+    e.p = text;
+    e.resolve = resolve;
+    e.address = 0;
+    v = expr_sum(&e);
+    if (*skip_space(e.p)) fail("junk after expression: '%s'", e.p);
+    if (address) *address = e.address;
+    return v;
+}
+
+// --- Instructions -----------------------------------------------------------
+
+enum {
+    LDA, LDX, LDY, STA, STX, STY, STZ, ADC, SBC, AND, ORA, EOR, CMP, CPX, CPY, BIT,
+    INC, DEC, ASL, LSR, ROL, ROR, INX, INY, DEX, DEY,
+    TAX, TAY, TXA, TYA, TXY, TYX, TCD, TDC, TCS, TSC, XBA, CLC, SEC, CLV, SEP, REP,
+    PHA, PLA, PHX, PLX, PHY, PLY, PHP, PLP, PHB, PLB, PHD, PLD, PHK, PEA,
+    BCC, BCS, BEQ, BNE, BMI, BPL, BVC, BVS, BRA, BRL, JMP, JML, JSR, JSL, RTS, RTL, NOP,
+    OP_COUNT
+};
+
+static const char* const s_opNames[OP_COUNT] = {
+    "lda", "ldx", "ldy", "sta", "stx", "sty", "stz", "adc", "sbc", "and", "ora", "eor",
+    "cmp", "cpx", "cpy", "bit", "inc", "dec", "asl", "lsr", "rol", "ror", "inx", "iny",
+    "dex", "dey", "tax", "tay", "txa", "tya", "txy", "tyx", "tcd", "tdc", "tcs", "tsc",
+    "xba", "clc", "sec", "clv", "sep", "rep", "pha", "pla", "phx", "plx", "phy", "ply",
+    "php", "plp", "phb", "plb", "phd", "pld", "phk", "pea", "bcc", "bcs", "beq", "bne",
+    "bmi", "bpl", "bvc", "bvs", "bra", "brl", "jmp", "jml", "jsr", "jsl", "rts", "rtl",
+    "nop",
+};
+
+enum { M_IMP, M_ACC, M_IMM, M_DP, M_DPX, M_DPY, M_ABS, M_ABSX, M_ABSY, M_LONG, M_LONGX, M_SR, M_REL };
+
+// Operand width of an instruction
+enum { W_NONE, W_M, W_X };
+
+static u8 op_width(u8 op) {
+    switch (op) {
+        case LDA: case STA: case STZ: case ADC: case SBC: case AND: case ORA: case EOR:
+        case CMP: case BIT: case INC: case DEC: case ASL: case LSR: case ROL: case ROR:
+        case PHA: case PLA:
+            return W_M;
+        case LDX: case LDY: case STX: case STY: case CPX: case CPY: case INX: case INY:
+        case DEX: case DEY: case PHX: case PLX: case PHY: case PLY:
+            return W_X;
+        default:
+            return W_NONE;
+    }
+}
+
+static int is_branch(u8 op) {
+    return op >= BCC && op <= BRL;
+}
+
+static int is_store(u8 op) {
+    return op == STA || op == STX || op == STY || op == STZ;
+}
+
+static int is_rmw(u8 op) {
+    return op == INC || op == DEC || op == ASL || op == LSR || op == ROL || op == ROR;
+}
+
+typedef struct Inst {
+    u8 op;
+    u8 mode;
+    u8 size;
+    u8 wide;  // Immediate assembled as 16 bits
+    u32 addr;
+    u32 value;
+    char expr[LINE_MAX];
+    const Line* line;
+} Inst;
+
+static Inst s_insts[MAX_INSTS];
+static u16 s_instCount;
+static s16 s_instAt[0x8000];  // Code bank offset - CODE_BASE -> instruction, or -1
+
+// --- Assembler --------------------------------------------------------------
+
+static u32 s_pc = CODE_BASE;
+static u8 s_accu16, s_index16;
+static u32 s_ramNext[256];  // Next free RAM address per bank
+
+static u32 ram_alloc(u8 bank, u32 size, u32 align) {
+    u32 at;
+
+    if (!s_ramNext[bank]) s_ramNext[bank] = (bank == 0) ? 0x0100 : 0x8000;
+    at = s_ramNext[bank];
+    if (align > 1) at = (at + align - 1) / align * align;
+    if (at + size > ((bank == 0) ? 0x2000u : 0x10000u)) fail("RAM section does not fit bank $%02X", bank);
+    s_ramNext[bank] = at + size;
+    return ((u32)bank << 16) | at;
+}
+
+static u8 find_op(const char* name) {
+    u8 i;
+
+    for (i = 0; i < OP_COUNT; i++) {
+        if (strcasecmp(s_opNames[i], name) == 0) return i;
+    }
+    fail("unsupported instruction '%s'", name);
+    return 0;
+}
+
+// Split "expr,x" into the expression and its index letter (0 if none)
+static char split_index(char* operand) {
+    char* comma = strrchr(operand, ',');
+    char* p;
+    char r;
+
+    if (!comma) return 0;
+    p = (char*)skip_space(comma + 1);
+    r = (char)tolower((unsigned char)*p);
+    if ((r != 'x' && r != 'y' && r != 's') || *skip_space(p + 1)) fail("bad operand '%s'", operand);
+    *comma = '\0';
+    return r;
+}
+
+static void parse_inst(const char* text) {
+    char mnemonic[NAME_MAX];
+    char operand[LINE_MAX];
+    char size = 0;
+    char index;
+    const char* p = text;
+    Inst* in;
+    u32 n = 0;
+    u8 address;
+    s32 v;
+
+    while (isalpha((unsigned char)*p) && n + 1 < sizeof(mnemonic)) mnemonic[n++] = *p++;
+    mnemonic[n] = '\0';
+    if (*p == '.') {
+        size = (char)tolower((unsigned char)p[1]);
+        if (size != 'b' && size != 'w' && size != 'l') fail("bad size suffix in '%s'", text);
+        p += 2;
+    }
+    copy_text(operand, sizeof(operand), skip_space(p));
+
+    if (s_instCount == MAX_INSTS) fail("too many instructions");
+    in = &s_insts[s_instCount++];
+    memset(in, 0, sizeof(*in));
+    in->op = find_op(mnemonic);
+    in->line = s_at;
+    in->addr = ((u32)CODE_BANK << 16) | s_pc;
+
+    if (!operand[0] || ((operand[0] == 'a' || operand[0] == 'A') && !operand[1])) {
+        in->mode = operand[0] ? M_ACC : M_IMP;
+        in->size = 1;
+    } else if (operand[0] == '#') {
+        in->mode = M_IMM;
+        copy_text(in->expr, sizeof(in->expr), operand + 1);
+        if (in->op == SEP || in->op == REP) {
+            in->size = 2;
+        } else {
+            switch (op_width(in->op)) {
+                case W_M: in->wide = s_accu16; break;
+                case W_X: in->wide = s_index16; break;
+                default: fail("%s has no immediate mode", mnemonic);
+            }
+            in->size = in->wide ? 3 : 2;
+        }
+    } else if (is_branch(in->op)) {
+        in->mode = M_REL;
+        copy_text(in->expr, sizeof(in->expr), operand);
+        in->size = (in->op == BRL) ? 3 : 2;
+    } else {
+        if (operand[0] == '(' || operand[0] == '[') fail("indirect addressing is not supported");
+        index = split_index(operand);
+        copy_text(in->expr, sizeof(in->expr), operand);
+        v = eval(in->expr, 0, &address);
+        if (!size) {
+            if (in->op == JML || in->op == JSL) size = 'l';
+            else if (in->op == PEA || in->op == JMP || in->op == JSR) size = 'w';
+            else if (index == 's' || (!address && v >= 0 && v < 0x100)) size = 'b';
+            else if (!address && v > 0xFFFF) size = 'l';
+            else size = 'w';
+        }
+        switch (size) {
+            case 'b':
+                in->mode = index == 'x' ? M_DPX : index == 'y' ? M_DPY : index == 's' ? M_SR : M_DP;
+                in->size = 2;
+                break;
+            case 'w':
+                if (index == 's') fail("stack relative takes an 8-bit offset");
+                in->mode = index == 'x' ? M_ABSX : index == 'y' ? M_ABSY : M_ABS;
+                in->size = 3;
+                break;
+            default:
+                if (index == 'y' || index == 's') fail("no long ,%c mode", index);
+                in->mode = index == 'x' ? M_LONGX : M_LONG;
+                in->size = 4;
+                break;
+        }
+        if ((in->mode == M_LONG || in->mode == M_LONGX) && in->op != LDA && in->op != STA &&
+            in->op != ADC && in->op != SBC && in->op != AND && in->op != ORA && in->op != EOR &&
+            in->op != CMP && in->op != JML && in->op != JSL) {
+            fail("%s has no long mode", mnemonic);
+        }
+    }
+    if (in->mode == M_IMM && is_store(in->op)) fail("%s has no immediate mode", mnemonic);
+    if ((in->op == JML || in->op == JSL) && in->mode != M_LONG) fail("%s needs a long address", mnemonic);
+
+    if (s_pc - CODE_BASE + in->size > sizeof(s_instAt) / sizeof(s_instAt[0])) fail("code bank full");
+    s_instAt[s_pc - CODE_BASE] = (s16)(s_instCount - 1);
+    s_pc += in->size;
+}
+
+static u8 parse_width(const char* p) {
+    s32 v = eval(p, 1, NULL);
+
+    if (v != 8 && v != 16) fail("width must be 8 or 16");
+    return v == 16;
+}
+
+// .RAMSECTION "name" BANK b SLOT s [ALIGN n]
+static void parse_ramsection(const char* p, u8* bank, u32* align) {
+    char word[NAME_MAX];
+
+    *bank = 0;
+    *align = 1;
+    p = skip_space(p);
+    if (*p == '"') {
+        p = strchr(p + 1, '"');
+        if (!p) fail("unterminated section name");
+        p++;
+    }
+    for (;;) {
+        p = skip_space(p);
+        if (!*p) break;
+        p = read_ident(p, word);
+        if (!word[0]) fail("bad .RAMSECTION option at '%s'", p);
+        p = skip_space(p);
+        if (strcasecmp(word, "BANK") == 0) {
+            *bank = (u8)strtoul(p[0] == '$' ? p + 1 : p, (char**)&p, p[0] == '$' ? 16 : 10);
+        } else if (strcasecmp(word, "SLOT") == 0) {
+            strtoul(p, (char**)&p, 10);  // Slot 1 is low WRAM in every bank used here
+        } else if (strcasecmp(word, "ALIGN") == 0) {
+            *align = (u32)strtoul(p, (char**)&p, 10);
+        } else {
+            fail("unsupported .RAMSECTION option %s", word);
+        }
+    }
+}
+
+// "name dsb n" / "name dsw n" / "name db" / "name dw" inside a RAM section
+static void parse_ram_entry(const char* p, u8 bank, u32 align) {
+    char name[NAME_MAX];
+    char kind[NAME_MAX];
+    u32 size;
+
+    p = skip_space(read_ident(p, name));
+    if (*p == ':') p = skip_space(p + 1);
+    p = skip_space(read_ident(p, kind));
+    if (strcasecmp(kind, "db") == 0) size = 1;
+    else if (strcasecmp(kind, "dw") == 0) size = 2;
+    else if (strcasecmp(kind, "dsb") == 0) size = (u32)eval(p, 1, NULL);
+    else if (strcasecmp(kind, "dsw") == 0) size = 2 * (u32)eval(p, 1, NULL);
+    else fail("unsupported RAM entry '%s'", kind);
+    set_symbol(name, ram_alloc(bank, size, align), SYM_ADDRESS);
+}
+
+static void assemble(void) {
+    u8 in_ram = 0, in_code = 0, ram_bank = 0, first_entry = 0;
+    u32 ram_align = 1;
+    char name[NAME_MAX];
+    u16 i;
+    Inst* in;
+    s32 v;
+    s32 dist;
+
+    memset(s_instAt, 0xFF, sizeof(s_instAt));
+    for (i = 0; i < s_lineCount; i++) {
+        const char* p = s_lines[i].text;
+        const char* after;
+
+        s_at = &s_lines[i];
+        if (!*p) continue;
+
+        if (*p == '.') {
+            if (strncasecmp(p, ".DEFINE", 7) == 0) {
+                p = skip_space(read_ident(skip_space(p + 7), name));
+                set_symbol(name, (u32)eval(p, 1, NULL), SYM_NUMBER);
+            } else if (strncasecmp(p, ".RAMSECTION", 11) == 0) {
+                parse_ramsection(p + 11, &ram_bank, &ram_align);
+                in_ram = 1;
+                first_entry = 1;
+            } else if (strncasecmp(p, ".SECTION", 8) == 0) {
+                in_code = 1;
+            } else if (strncasecmp(p, ".ENDS", 5) == 0) {
+                in_ram = in_code = 0;
+            } else if (strncasecmp(p, ".ACCU", 5) == 0) {
+                s_accu16 = parse_width(p + 5);
+            } else if (strncasecmp(p, ".INDEX", 6) == 0) {
+                s_index16 = parse_width(p + 6);
+            } else {
+                fail("unsupported directive '%s'", p);
+            }
+            continue;
+        }
+        if (in_ram) {
+            // Only the first entry gets the section's alignment
+            parse_ram_entry(p, ram_bank, first_entry ? ram_align : 1);
+            first_entry = 0;
+            continue;
+        }
+
+        // Label, alone or before an instruction
+        after = read_ident(p, name);
+        if (name[0] && *after == ':') {
+            set_symbol(name, ((u32)CODE_BANK << 16) | s_pc, SYM_ADDRESS);
+            p = skip_space(after + 1);
+            if (!*p) continue;
+        }
+        if (!in_code) fail("code outside a .SECTION");
+        parse_inst(p);
+    }
+
+    // Second pass: every label is known now
+    for (i = 0; i < s_instCount; i++) {
+        in = &s_insts[i];
+        s_at = in->line;
+        if (in->mode == M_IMP || in->mode == M_ACC) continue;
+        v = eval(in->expr, 1, NULL);
+        in->value = (u32)v;
+        if (in->mode == M_REL) {
+            dist = (s32)((u32)v & 0xFFFF) - (s32)((in->addr & 0xFFFF) + in->size);
+            if ((u32)v >> 16 != CODE_BANK || (in->op != BRL && (dist < -128 || dist > 127))) {
+                fail("branch target out of range");
+            }
+        } else if (in->mode == M_IMM && (v < -0x8000 || v > 0xFFFF)) {
+            fail("immediate out of range");
+        }
+    }
+    s_at = NULL;
+}
+
+void sim65_load(const char* path) {
+    preprocess(path);
+    assemble();
+}
+
+// --- Memory -----------------------------------------------------------------
+
+static u8 s_wram[0x20000];
+static u32 s_dataBytes;  // WRAM accesses by the current instruction
+
+u8* sim65_mem(u32 addr) {
+    const u8 bank = (u8)(addr >> 16);
+    const u16 off = (u16)addr;
+
+    if (bank == 0x7E || bank == 0x7F) return &s_wram[((u32)(bank - 0x7E) << 16) | off];
+    if ((bank & 0x7F) < 0x40 && off < 0x2000) return &s_wram[off];
+    fail("access to $%02X:%04X, which is not WRAM", bank, off);
+    return NULL;
+}
+
+static u8 rd8(u32 addr) {
+    s_dataBytes++;
+    return *sim65_mem(addr & 0xFFFFFF);
+}
+
+static void wr8(u32 addr, u8 v) {
+    s_dataBytes++;
+    *sim65_mem(addr & 0xFFFFFF) = v;
+}
+
+// --- CPU --------------------------------------------------------------------
+
+#define P_C 0x01
+#define P_Z 0x02
+#define P_I 0x04
+#define P_D 0x08
+#define P_X 0x10
+#define P_M 0x20
+#define P_V 0x40
+#define P_N 0x80
+
+static u16 s_a, s_x, s_y, s_s, s_d;
+static u8 s_p, s_db, s_pb;
+static u16 s_pcReg;
+static u8 s_stop;
+
+static void push8(u8 v) {
+    wr8(s_s, v);
+    s_s--;
+}
+
+static u8 pull8(void) {
+    s_s++;
+    return rd8(s_s);
+}
+
+static void push16(u16 v) {
+    push8((u8)(v >> 8));
+    push8((u8)v);
+}
+
+static u16 pull16(void) {
+    const u16 lo = pull8();
+    return (u16)(lo | (pull8() << 8));
+}
+
+static void set_p(u8 p) {
+    s_p = p;
+    if (s_p & P_X) {
+        s_x &= 0xFF;
+        s_y &= 0xFF;
+    }
+}
+
+static void set_nz(u16 v, u8 wide) {
+    s_p &= (u8)~(P_N | P_Z);
+    if (wide) {
+        if (!v) s_p |= P_Z;
+        if (v & 0x8000) s_p |= P_N;
+    } else {
+        if (!(v & 0xFF)) s_p |= P_Z;
+        if (v & 0x80) s_p |= P_N;
+    }
+}
+
+// Effective address; direct page and stack addressing stay in bank 0
+static u32 effective(const Inst* in, u8* crossed) {
+    u32 base;
+    u16 idx;
+
+    *crossed = 0;
+    switch (in->mode) {
+        case M_DP: return (u16)(s_d + in->value);
+        case M_DPX: return (u16)(s_d + in->value + s_x);
+        case M_DPY: return (u16)(s_d + in->value + s_y);
+        case M_SR: return (u16)(s_s + in->value);
+        case M_ABS: return ((u32)s_db << 16) | (u16)in->value;
+        case M_ABSX:
+        case M_ABSY:
+            base = ((u32)s_db << 16) | (u16)in->value;
+            idx = (in->mode == M_ABSX) ? s_x : s_y;
+            *crossed = (((base + idx) ^ base) & 0xFFFF00) != 0;
+            return (base + idx) & 0xFFFFFF;
+        case M_LONG: return in->value & 0xFFFFFF;
+        case M_LONGX: return (in->value + s_x) & 0xFFFFFF;
+        default: fail("bad addressing mode for %s", s_opNames[in->op]);
+    }
+    return 0;
+}
+
+static int bank0_mode(u8 mode) {
+    return mode == M_DP || mode == M_DPX || mode == M_DPY || mode == M_SR;
+}
+
+static u16 rd(u32 ea, u8 wide, u8 mode) {
+    u16 v = rd8(ea);
+
+    if (wide) v |= (u16)rd8(bank0_mode(mode) ? (u16)(ea + 1) : ea + 1) << 8;
+    return v;
+}
+
+static void wr(u32 ea, u16 v, u8 wide, u8 mode) {
+    wr8(ea, (u8)v);
+    if (wide) wr8(bank0_mode(mode) ? (u16)(ea + 1) : ea + 1, (u8)(v >> 8));
+}
+
+// Cycles for an instruction, before the branch-taken cycle
+static u32 cycles(const Inst* in, u8 wide, u8 crossed) {
+    const u8 dp_penalty = bank0_mode(in->mode) && in->mode != M_SR && (s_d & 0xFF);
+    u32 c;
+
+    if (in->mode == M_IMM && op_width(in->op) != W_NONE) return 2 + wide;
+    if (op_width(in->op) != W_NONE && in->mode != M_IMP && in->mode != M_ACC) {
+        if (is_rmw(in->op)) {
+            c = (in->mode == M_DP) ? 5 : (in->mode == M_DPX || in->mode == M_ABS) ? 6 : 7;
+            return c + 2 * wide + dp_penalty;
+        }
+        switch (in->mode) {
+            case M_DP: c = 3; break;
+            case M_DPX: case M_DPY: c = 4; break;
+            case M_ABS: c = 4; break;
+            case M_ABSX: case M_ABSY:
+                c = is_store(in->op) ? 5 : 4 + ((!(s_p & P_X) || crossed) ? 1 : 0);
+                break;
+            case M_LONG: case M_LONGX: c = 5; break;
+            default: c = 4; break;  // M_SR
+        }
+        return c + wide + dp_penalty;
+    }
+    switch (in->op) {
+        case XBA: return 3;
+        case SEP: case REP: return 3;
+        case PHA: case PHX: case PHY: return 3 + wide;
+        case PLA: case PLX: case PLY: return 4 + wide;
+        case PHP: case PHB: case PHK: return 3;
+        case PLP: case PLB: return 4;
+        case PHD: return 4;
+        case PLD: return 5;
+        case PEA: return 5;
+        case BRA: return 3;
+        case BRL: return 4;
+        case JMP: return 3;
+        case JML: return 4;
+        case JSR: return 6;
+        case JSL: return 8;
+        case RTS: case RTL: return 6;
+        default: return 2;  // Implied, accumulator and untaken branches
+    }
+}
+
+static u16 adc(u16 a, u16 m, u8 wide) {
+    const u32 mask = wide ? 0xFFFF : 0xFF;
+    const u32 sign = wide ? 0x8000 : 0x80;
+    const u32 r = (a & mask) + (m & mask) + (s_p & P_C);
+
+    if (s_p & P_D) fail("decimal mode is not supported");
+    s_p &= (u8)~(P_C | P_V);
+    if (r > mask) s_p |= P_C;
+    if (~(a ^ m) & (a ^ r) & sign) s_p |= P_V;
+    set_nz((u16)(r & mask), wide);
+    return (u16)(r & mask);
+}
+
+static void compare(u16 reg, u16 m, u8 wide) {
+    const u16 mask = wide ? 0xFFFF : 0xFF;
+
+    reg &= mask;
+    m &= mask;
+    if (reg >= m) s_p |= P_C;
+    else s_p &= (u8)~P_C;
+    set_nz((u16)(reg - m), wide);
+}
+
+// Store v into A (all of C when wide, else only the low byte)
+static void set_a(u16 v, u8 wide) {
+    s_a = wide ? v : (u16)((s_a & 0xFF00) | (v & 0xFF));
+}
+
+static u16 shift(u8 op, u16 v, u8 wide) {
+    const u16 mask = wide ? 0xFFFF : 0xFF;
+    const u16 sign = wide ? 0x8000 : 0x80;
+    const u8 carry_in = s_p & P_C;
+    u16 r;
+
+    s_p &= (u8)~P_C;
+    switch (op) {
+        case ASL: if (v & sign) s_p |= P_C; r = (u16)(v << 1); break;
+        case ROL: if (v & sign) s_p |= P_C; r = (u16)((v << 1) | carry_in); break;
+        case LSR: if (v & 1) s_p |= P_C; r = (u16)((v & mask) >> 1); break;
+        default: if (v & 1) s_p |= P_C; r = (u16)(((v & mask) >> 1) | (carry_in ? sign : 0)); break;
+    }
+    r &= mask;
+    set_nz(r, wide);
+    return r;
+}
+
+static int branch_taken(u8 op) {
+    switch (op) {
+        case BCC: return !(s_p & P_C);
+        case BCS: return (s_p & P_C) != 0;
+        case BEQ: return (s_p & P_Z) != 0;
+        case BNE: return !(s_p & P_Z);
+        case BMI: return (s_p & P_N) != 0;
+        case BPL: return !(s_p & P_N);
+        case BVC: return !(s_p & P_V);
+        case BVS: return (s_p & P_V) != 0;
+        default: return 1;
+    }
+}
+
+static void step(void) {
+    const u8 m16 = !(s_p & P_M);
+    const u8 x16 = !(s_p & P_X);
+    const Inst* in;
+    u8 wide = 0, crossed = 0, taken = 0, has_ea;
+    u32 ea = 0;
+    u16 v = 0;
+    u32 c, io;
+    s16 idx;
+
+    if (s_pb != CODE_BANK || (u16)(s_pcReg - CODE_BASE) >= 0x8000 ||
+        (idx = s_instAt[s_pcReg - CODE_BASE]) < 0) {
+        s_at = NULL;
+        fail("jumped to $%02X:%04X, which is not an instruction", s_pb, s_pcReg);
+    }
+    in = &s_insts[idx];
+    s_at = in->line;
+    s_dataBytes = 0;
+
+    switch (op_width(in->op)) {
+        case W_M: wide = m16; break;
+        case W_X: wide = x16; break;
+    }
+    if (in->mode == M_IMM && op_width(in->op) != W_NONE && in->wide != wide) {
+        fail("%s # assembled for %d-bit operands but runs with %d-bit ones", s_opNames[in->op],
+             in->wide ? 16 : 8, wide ? 16 : 8);
+    }
+
+    s_pcReg = (u16)(s_pcReg + in->size);
+    // Jumps and PEA take their operand as a value, not as a memory address
+    has_ea = in->mode != M_IMP && in->mode != M_ACC && in->mode != M_IMM && in->mode != M_REL &&
+             in->op != JMP && in->op != JML && in->op != JSR && in->op != JSL && in->op != PEA;
+    if (has_ea) ea = effective(in, &crossed);
+
+    // Operand for reads
+    if (in->mode == M_IMM) {
+        v = (u16)in->value;
+    } else if (has_ea) {
+        switch (in->op) {
+            case LDA: case LDX: case LDY: case ADC: case SBC: case AND: case ORA: case EOR:
+            case CMP: case CPX: case CPY: case BIT:
+                v = rd(ea, wide, in->mode);
+                break;
+        }
+    }
+
+    switch (in->op) {
+        case LDA: set_a(v, wide); set_nz(v, wide); break;
+        case LDX: s_x = v; set_nz(v, wide); break;
+        case LDY: s_y = v; set_nz(v, wide); break;
+        case STA: wr(ea, s_a, wide, in->mode); break;
+        case STX: wr(ea, s_x, wide, in->mode); break;
+        case STY: wr(ea, s_y, wide, in->mode); break;
+        case STZ: wr(ea, 0, wide, in->mode); break;
+        case ADC: set_a(adc(s_a, v, wide), wide); break;
+        case SBC: set_a(adc(s_a, (u16)~v, wide), wide); break;
+        case AND: v &= s_a; set_a(v, wide); set_nz(v, wide); break;
+        case ORA: v |= s_a; set_a(v, wide); set_nz(v, wide); break;
+        case EOR: v ^= s_a; set_a(v, wide); set_nz(v, wide); break;
+        case CMP: compare(s_a, v, wide); break;
+        case CPX: compare(s_x, v, wide); break;
+        case CPY: compare(s_y, v, wide); break;
+        case BIT:
+            if (in->mode != M_IMM) {
+                s_p &= (u8)~(P_N | P_V);
+                s_p |= (u8)((wide ? v >> 8 : v) & (P_N | P_V));
+            }
+            s_p &= (u8)~P_Z;
+            if (!(v & s_a & (wide ? 0xFFFF : 0xFF))) s_p |= P_Z;
+            break;
+        case INC: case DEC: case ASL: case LSR: case ROL: case ROR:
+            if (in->mode == M_ACC) {
+                v = s_a;
+            } else {
+                v = rd(ea, wide, in->mode);
+            }
+            if (in->op == INC || in->op == DEC) {
+                v = (u16)(v + (in->op == INC ? 1 : -1));
+                if (!wide) v &= 0xFF;
+                set_nz(v, wide);
+            } else {
+                v = shift(in->op, v, wide);
+            }
+            if (in->mode == M_ACC) set_a(v, wide);
+            else wr(ea, v, wide, in->mode);
+            break;
+        case INX: s_x = (u16)(s_x + 1) & (x16 ? 0xFFFF : 0xFF); set_nz(s_x, x16); break;
+        case INY: s_y = (u16)(s_y + 1) & (x16 ? 0xFFFF : 0xFF); set_nz(s_y, x16); break;
+        case DEX: s_x = (u16)(s_x - 1) & (x16 ? 0xFFFF : 0xFF); set_nz(s_x, x16); break;
+        case DEY: s_y = (u16)(s_y - 1) & (x16 ? 0xFFFF : 0xFF); set_nz(s_y, x16); break;
+        case TAX: s_x = x16 ? s_a : (s_a & 0xFF); set_nz(s_x, x16); break;
+        case TAY: s_y = x16 ? s_a : (s_a & 0xFF); set_nz(s_y, x16); break;
+        case TXA: set_a(s_x, m16); set_nz(s_a, m16); break;
+        case TYA: set_a(s_y, m16); set_nz(s_a, m16); break;
+        case TXY: s_y = s_x; set_nz(s_y, x16); break;
+        case TYX: s_x = s_y; set_nz(s_x, x16); break;
+        case TCD: s_d = s_a; set_nz(s_d, 1); break;
+        case TDC: s_a = s_d; set_nz(s_a, 1); break;
+        case TCS: s_s = s_a; break;
+        case TSC: s_a = s_s; set_nz(s_a, 1); break;
+        case XBA: s_a = (u16)((s_a >> 8) | (s_a << 8)); set_nz(s_a, 0); break;
+        case CLC: s_p &= (u8)~P_C; break;
+        case SEC: s_p |= P_C; break;
+        case CLV: s_p &= (u8)~P_V; break;
+        case SEP: set_p(s_p | (u8)in->value); break;
+        case REP: set_p(s_p & (u8)~in->value); break;
+        case PHA: if (wide) push16(s_a); else push8((u8)s_a); break;
+        case PHX: if (wide) push16(s_x); else push8((u8)s_x); break;
+        case PHY: if (wide) push16(s_y); else push8((u8)s_y); break;
+        case PLA: v = wide ? pull16() : pull8(); set_a(v, wide); set_nz(v, wide); break;
+        case PLX: s_x = wide ? pull16() : pull8(); set_nz(s_x, wide); break;
+        case PLY: s_y = wide ? pull16() : pull8(); set_nz(s_y, wide); break;
+        case PHP: push8(s_p); break;
+        case PLP: set_p(pull8()); break;
+        case PHB: push8(s_db); break;
+        case PLB: s_db = pull8(); set_nz(s_db, 0); break;
+        case PHD: push16(s_d); break;
+        case PLD: s_d = pull16(); set_nz(s_d, 1); break;
+        case PHK: push8(s_pb); break;
+        case PEA: push16((u16)in->value); break;
+        case BCC: case BCS: case BEQ: case BNE: case BMI: case BPL: case BVC: case BVS:
+        case BRA: case BRL:
+            taken = (u8)branch_taken(in->op);
+            if (taken) s_pcReg = (u16)in->value;
+            break;
+        case JMP: s_pcReg = (u16)in->value; break;
+        case JML: s_pb = (u8)(in->value >> 16); s_pcReg = (u16)in->value; break;
+        case JSR: push16((u16)(s_pcReg - 1)); s_pcReg = (u16)in->value; break;
+        case JSL:
+            push8(s_pb);
+            push16((u16)(s_pcReg - 1));
+            s_pb = (u8)(in->value >> 16);
+            s_pcReg = (u16)in->value;
+            break;
+        case RTS: s_pcReg = (u16)(pull16() + 1); break;
+        case RTL: {
+            const u16 pc = pull16();
+            const u8 pb = pull8();
+            if ((((u32)pb << 16) | pc) == RETURN_SENTINEL - 1) {
+                s_stop = 1;
+            } else {
+                s_pb = pb;
+                s_pcReg = (u16)(pc + 1);
+            }
+            break;
+        }
+        case NOP: break;
+    }
+
+    // Timing: branches only pay for the taken cycle (native mode)
+    c = cycles(in, wide, crossed);
+    if (is_branch(in->op) && in->op != BRA && in->op != BRL && taken) c++;
+    if (c < in->size + s_dataBytes) fail("internal: cycle table too low for %s", s_opNames[in->op]);
+    io = c - in->size - s_dataBytes;
+    g_sim65.instructions++;
+    g_sim65.cycles += c;
+    g_sim65.master_slow += in->size * 8 + s_dataBytes * 8 + io * 6;
+    g_sim65.master_fast += in->size * 6 + s_dataBytes * 8 + io * 6;
+}
+
+void sim65_call(const char* label, const u16* args, u8 nargs) {
+    const u32 entry = sim65_symbol(label);
+    u32 steps = 0;
+    u16 sp;
+    u8 i;
+
+    s_s = 0x1FFF;
+    s_d = 0;
+    s_db = 0x7E;
+    set_p(0);  // Native mode, 16-bit A and index, as 816-tcc code runs
+    for (i = nargs; i > 0; i--) push16(args[i - 1]);
+    sp = s_s;
+    push8((u8)((RETURN_SENTINEL - 1) >> 16));
+    push16((u16)(RETURN_SENTINEL - 1));
+
+    s_pb = (u8)(entry >> 16);
+    s_pcReg = (u16)entry;
+    s_stop = 0;
+    while (!s_stop) {
+        if (++steps > STEP_LIMIT) fail("%s: no RTL after %u instructions", label, STEP_LIMIT);
+        step();
+    }
+    s_at = NULL;
+    if (s_s != sp) fail("%s: stack off by %d bytes at RTL", label, (int)s_s - (int)sp);
+}
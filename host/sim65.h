@@ -0,0 +1,54 @@
+#ifndef STARSHMUP_HOST_SIM65_H
+#define STARSHMUP_HOST_SIM65_H
+
+// 65816 simulator for the host build: assembles the WLA-DX subset used by
+// the hand-written kernels (kernels.asm) and runs them in native mode, so
+// they can be checked against their C references and timed without a ROM.
+//
+// Assembler: .DEFINE, .MACRO / .ENDM (ARGS names, \@), .RAMSECTION /
+// .ENDS with dsb / dsw / db / dw, .SECTION / .ENDS, .ACCU, .INDEX and
+// labels; .include is skipped. Operands without a size suffix are absolute
+// unless they are plain numbers below $100 (direct page); .b / .w / .l
+// force the size. The interpreter stops with an error on anything the
+// kernels should never do: an immediate assembled for the other register
+// width, decimal mode, an I/O access or an unsupported instruction.
+//
+// Memory is the 128 KB of WRAM at $7E:0000, with its first 8 KB mirrored
+// at $0000 in banks $00-$3F and $80-$BF. Code runs from bank $01 and does
+// not occupy memory. RAM sections go to bank $00 (from $0100) or to the
+// bank they name. Symbols the code needs from C are defined up front.
+//
+// Cycles are counted per instruction from the data sheet tables, including
+// the 16-bit, index-crossing and direct page penalties. Master cycles
+// split them into program bytes (8 master cycles each from SlowROM, 6 from
+// FastROM), data bytes (8, WRAM) and internal cycles (6).
+
+#include <snes.h>
+
+typedef struct Sim65Stats {
+    uint64_t instructions;
+    uint64_t cycles;
+    uint64_t master_slow;  // Code in SlowROM
+    uint64_t master_fast;  // Code in FastROM
+} Sim65Stats;
+
+extern Sim65Stats g_sim65;
+
+// Make a C-side symbol (24-bit address) visible to the assembly
+void sim65_define(const char* name, u32 addr);
+
+// Assemble a source file; exits with a message on errors
+void sim65_load(const char* path);
+
+// Address of a label, RAM label or defined symbol; exits if unknown
+u32 sim65_symbol(const char* name);
+
+// WRAM behind a 24-bit address, for copying state in and out
+u8* sim65_mem(u32 addr);
+
+// Call a routine the way 816-tcc does: args pushed as 16-bit words, last
+// one first, then JSL. Runs until the matching RTL with D = 0, DB = $7E
+// and 16-bit registers, and adds what it cost to g_sim65.
+void sim65_call(const char* label, const u16* args, u8 nargs);
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef STARSHMUP_HOST_SNES_H
+#define STARSHMUP_HOST_SNES_H
+
+// Stand-in for PVSnesLib's <snes.h> in the host build. Provides the types,
+// constants and library calls the simulation modules use; the calls are
+// no-ops (snes_stub.c) and I/O registers are plain bytes in g_hostIo.
+
+#include <stdint.h>
+
+typedef uint8_t u8;
+typedef int8_t s8;
+typedef uint16_t u16;
+typedef int16_t s16;
+typedef uint32_t u32;
+typedef int32_t s32;
+typedef volatile uint8_t vuint8;
+typedef volatile uint16_t vuint16;
+
+// Pad bits, as read by padsCurrent()
+#define KEY_A      0x0080
+#define KEY_X      0x0040
+#define KEY_L      0x0020
+#define KEY_R      0x0010
+#define KEY_RIGHT  0x0100
+#define KEY_LEFT   0x0200
+#define KEY_DOWN   0x0400
+#define KEY_UP     0x0800
+#define KEY_START  0x1000
+#define KEY_SELECT 0x2000
+#define KEY_Y      0x4000
+#define KEY_B      0x8000
+
+#define OBJ_SMALL 0
+#define OBJ_LARGE 1
+#define OBJ_SHOW 0
+#define OBJ_HIDE 1
+#define OBJ_SIZE8_L16 (0 << 5)
+#define SC_32x32 0
+#define BG_MODE1 1
+
+extern u8 g_hostIo[0x10000];
+#define HOST_REG(addr) (*(vuint8*)&g_hostIo[addr])
+
+#define REG_BG2SC HOST_REG(0x2108)
+#define REG_BG2VOFS HOST_REG(0x2110)
+
+extern u8 oamMemory[128 * 4 + 32];
+
+void oamInitGfxAttr(u16 address, u8 oamsize);
+void oamUpdate(void);
+
+u16 padsCurrent(u16 value);
+void WaitForVBlank(void);
+
+void dmaCopyVram(u8* source, u16 address, u16 size);
+void dmaCopyCGram(u8* source, u16 address, u16 size);
+
+#endif
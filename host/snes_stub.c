@@ -0,0 +1,34 @@
+#include <snes.h>
+
+// Library calls the simulation reaches, as no-ops
+
+u8 g_hostIo[0x10000];
+u8 oamMemory[128 * 4 + 32];
+
+void oamInitGfxAttr(u16 address, u8 oamsize) {
+    (void)address;
+    (void)oamsize;
+}
+
+void oamUpdate(void) {
+}
+
+u16 padsCurrent(u16 value) {
+    (void)value;
+    return 0;
+}
+
+void WaitForVBlank(void) {
+}
+
+void dmaCopyVram(u8* source, u16 address, u16 size) {
+    (void)source;
+    (void)address;
+    (void)size;
+}
+
+void dmaCopyCGram(u8* source, u16 address, u16 size) {
+    (void)source;
+    (void)address;
+    (void)size;
+}
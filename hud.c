@@ -0,0 +1,142 @@
+#include <snes.h>
+
+#include "hud.h"
+#include "xfer.h"
+
+#define HUD_ROW 1
+#define HUD_LEVEL_LABEL_X 1
+#define HUD_LEVEL_VALUE_X 8
+#define HUD_KILLS_LABEL_X 13
+#define HUD_KILLS_VALUE_X 20
+#define HUD_VALUE_WIDTH 5
+
+#define HUD_TILE(c) ((u16)((c) - ' ') + TEXT_TILE_OFFSET)
+#define HUD_DIGIT_TILE(d) (HUD_TILE('0') + (d))
+
+// Shadow of the visible text tilemap, the only copy the game writes
+static u16 s_map[TEXT_ROWS][TEXT_COLS];
+// Rows whose upload did not fit the transfer queue, so VRAM may not match
+// s_map; hud_update() sends each of them again in full
+static u8 s_rowDirty[TEXT_ROWS];
+static u8 s_dirtyRows;
+// Columns changed by put_tile() since the last flush_span(); s_first is
+// 0xFF when nothing changed
+static u8 s_first = 0xFF;
+static u8 s_last;
+
+static void mark_dirty(u8 y) {
+    if (!s_rowDirty[y]) {
+        s_rowDirty[y] = 1;
+        s_dirtyRows++;
+    }
+}
+
+static void put_tile(u8 x, u8 y, u16 tile) {
+    if (s_map[y][x] != tile) {
+        s_map[y][x] = tile;
+        if (s_first == 0xFF || x < s_first) s_first = x;
+        if (x > s_last) s_last = x;
+    }
+}
+
+// Queue the columns of row y changed since the last flush. A dirty row is
+// left to hud_update(), which sends all of it anyway.
+static void flush_span(u8 y) {
+    if (s_first == 0xFF) return;
+    if (s_rowDirty[y] ||
+        !xfer_queue(XFER_VRAM, (const u8*)&s_map[y][s_first],
+                    TEXT_MAP_BASE + (y * TEXT_COLS) + s_first,
+                    (u16)(s_last - s_first + 1) * 2, XFER_PRIO_NORMAL)) {
+        mark_dirty(y);
+    }
+    s_first = 0xFF;
+    s_last = 0;
+}
+
+static void put_text(u8 x, u8 y, const char* text) {
+    while (*text && x < TEXT_COLS) {
+        put_tile(x++, y, HUD_TILE(*text++));
+    }
+}
+
+// Write the low HUD_VALUE_WIDTH digits of v left-aligned, blank-padded
+static void put_value(u8 x, const Bcd* v) {
+    u8 digits = HUD_VALUE_WIDTH;
+    u8 i;
+
+    // Significant digits (at least one)
+    while (digits > 1 && BCD_DIGIT(v, digits - 1) == 0) digits--;
+
+    for (i = 0; i < HUD_VALUE_WIDTH; i++) {
+        put_tile(x + i, HUD_ROW,
+                 (i < digits) ? HUD_DIGIT_TILE(BCD_DIGIT(v, digits - 1 - i)) : HUD_TILE(' '));
+    }
+}
+
+static void clear_row(u8 y) {
+    u8 x;
+    for (x = 0; x < TEXT_COLS; x++) {
+        put_tile(x, y, HUD_TILE(' '));
+    }
+}
+
+void hud_init(void) {
+    u8 x, y;
+
+    for (y = 0; y < TEXT_ROWS; y++) {
+        for (x = 0; x < TEXT_COLS; x++) {
+            s_map[y][x] = HUD_TILE(' ');
+        }
+        s_rowDirty[y] = 0;
+    }
+    s_dirtyRows = 0;
+    if (!xfer_queue(XFER_VRAM, (const u8*)s_map, TEXT_MAP_BASE, sizeof(s_map),
+                    XFER_PRIO_NORMAL)) {
+        for (y = 0; y < TEXT_ROWS; y++) mark_dirty(y);
+    }
+}
+
+void hud_text(u8 x, u8 y, const char* text) {
+    put_text(x, y, text);
+    flush_span(y);
+}
+
+void hud_show(const Bcd* level, const Bcd* kills) {
+    clear_row(HUD_ROW);
+    put_text(HUD_LEVEL_LABEL_X, HUD_ROW, "LEVEL:");
+    put_text(HUD_KILLS_LABEL_X, HUD_ROW, "KILLS:");
+    put_value(HUD_LEVEL_VALUE_X, level);
+    put_value(HUD_KILLS_VALUE_X, kills);
+    flush_span(HUD_ROW);
+}
+
+void hud_set_level(const Bcd* level) {
+    put_value(HUD_LEVEL_VALUE_X, level);
+    flush_span(HUD_ROW);
+}
+
+void hud_set_kills(const Bcd* kills) {
+    put_value(HUD_KILLS_VALUE_X, kills);
+    flush_span(HUD_ROW);
+}
+
+void hud_hide(void) {
+    clear_row(HUD_ROW);
+    flush_span(HUD_ROW);
+}
+
+void hud_update(void) {
+    u8 y;
+
+    if (!s_dirtyRows) return;
+    for (y = 0; y < TEXT_ROWS; y++) {
+        if (s_rowDirty[y]) {
+            if (!xfer_queue(XFER_VRAM, (const u8*)s_map[y], TEXT_MAP_BASE + (y * TEXT_COLS),
+                            sizeof(s_map[y]), XFER_PRIO_NORMAL)) {
+                return;  // Queue still full; try the rest next frame
+            }
+            s_rowDirty[y] = 0;
+            s_dirtyRows--;
+        }
+    }
+}
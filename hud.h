@@ -0,0 +1,37 @@
+#ifndef STARSHMUP_HUD_H
+#define STARSHMUP_HUD_H
+
+#include <snes.h>
+
+#include "bcd.h"
+
+// Console text layer (BG1) VRAM layout, shared with consoleInitText()
+#define TEXT_MAP_BASE 0x6800
+#define TEXT_GFX_BASE 0x3000
+#define TEXT_TILE_OFFSET 0x0100  // Font tile 0 (' ') as set by consoleSetTextOffset()
+#define TEXT_COLS 32
+#define TEXT_ROWS 28  // Visible rows of the 32x32 map
+
+// Owner of the BG1 text tilemap: the gameplay HUD (LEVEL / KILLS) and the
+// scenes' text. The map is kept as a WRAM shadow and changes go to VRAM
+// through the VBlank transfer queue, so all text shares the xfer budget.
+// PVSnesLib's consoleDrawText() is not used: its own map buffer would be a
+// second copy, uploaded in full outside the budget. Writes compare tiles
+// against the shadow and queue only the span that changed. An upload the
+// queue turns away marks its row dirty, and hud_update() (once per frame)
+// queues the whole row again until it is accepted.
+
+// Blank the map and queue all of it (at boot, before the forced-blank flush)
+void hud_init(void);
+// Write text at tile (x, y); clipped at the right edge
+void hud_text(u8 x, u8 y, const char* text);
+// Re-queue rows left dirty by a full transfer queue (once per frame)
+void hud_update(void);
+
+// HUD row. Values are BCD counters.
+void hud_show(const Bcd* level, const Bcd* kills);
+void hud_set_level(const Bcd* level);
+void hud_set_kills(const Bcd* kills);
+void hud_hide(void);
+
+#endif
@@ -0,0 +1,94 @@
+#include <snes.h>
+
+#include "hwmath.h"
+
+#ifdef HOST_BUILD
+
+// Host build (host/): the same results in plain C
+
+u16 g_hwMulResult;
+
+u16 hw_mul8(u8 a, u8 b) {
+    return (u16)(a * b);
+}
+
+u16 hw_div(u16 a, u8 b) {
+    return b ? (u16)(a / b) : 0xFFFF;
+}
+
+u16 hw_mod(u16 a, u8 b) {
+    return b ? (u16)(a % b) : a;
+}
+
+s16 hw_mul_s16_s8(s16 a, s8 b) {
+    return (s16)(a * b);
+}
+
+s16 fx_mul(s16 a, s16 b) {
+    return (s16)(((s32)a * b) >> 8);
+}
+
+#else
+
+u16 hw_mul8(u8 a, u8 b) {
+    REG_WRMPYA = a;
+    REG_WRMPYB = b;
+    (void)REG_RDMPYL;  // Pad out the 8-cycle latency
+    return HW_MUL8_RESULT();
+}
+
+static void start_div(u16 a, u8 b) {
+    REG_WRDIVL = (u8)a;
+    REG_WRDIVH = (u8)(a >> 8);
+    REG_WRDIVB = b;
+    // 16-cycle latency; three long reads (5 cycles each) plus the loads
+    // of the result cover it
+    (void)REG_RDDIVL;
+    (void)REG_RDDIVL;
+    (void)REG_RDDIVL;
+}
+
+u16 hw_div(u16 a, u8 b) {
+    start_div(a, b);
+    return (u16)(REG_RDDIVL | ((u16)REG_RDDIVH << 8));
+}
+
+u16 hw_mod(u16 a, u8 b) {
+    start_div(a, b);
+    return HW_MUL8_RESULT();  // Remainder shares $4216/$4217
+}
+
+s16 hw_mul_s16_s8(s16 a, s8 b) {
+    REG_M7A = (u8)a;
+    REG_M7A = (u8)(a >> 8);
+    REG_M7B = (u8)b;
+    return (s16)(REG_MPYL | ((u16)REG_MPYM << 8));
+}
+
+s16 fx_mul(s16 a, s16 b) {
+    const u8 lo = (u8)b;
+    s16 hi_part, lo_part;
+
+    REG_M7A = (u8)a;
+    REG_M7A = (u8)(a >> 8);
+
+    // a * high byte of b: (a * bh * 256) >> 8 == a * bh
+    REG_M7B = (u8)(b >> 8);
+    hi_part = (s16)(REG_MPYL | ((u16)REG_MPYM << 8));
+
+    // a * low byte of b, treating it as signed and correcting below;
+    // M7A keeps its value between multiplies
+    REG_M7B = lo;
+    lo_part = (s16)(REG_MPYM | ((u16)REG_MPYH << 8));
+
+    // An unsigned low byte >= 128 read as signed is 256 too small
+    if (lo & 0x80) lo_part += a;
+
+    return hi_part + lo_part;
+}
+
+#endif
+
+u8 hw_range(u16 r, u8 n) {
+    return (u8)(hw_mul8((u8)(r >> 8), n) >> 8);
+}
@@ -0,0 +1,68 @@
+#ifndef STARSHMUP_HWMATH_H
+#define STARSHMUP_HWMATH_H
+
+#include <snes.h>
+
+// Integer math on the SNES hardware multiplier/divider.
+//
+// CPU unit ($4202-$4206 in, $4214-$4217 out): unsigned 8x8 multiply ready
+// 8 cycles after writing $4203, unsigned 16/8 divide ready 16 cycles after
+// writing $4206. PPU unit ($211B/$211C in, $2134-$2136 out): signed 16x8
+// multiply with the result ready immediately; usable outside Mode 7.
+//
+// The compiler's tcc__mul/tcc__udiv routines loop once per bit in software,
+// so even with call overhead these are several times cheaper. Hot code that
+// cannot afford a call uses the HW_MUL8 macro directly.
+
+#ifndef REG_WRMPYA
+#define REG_WRMPYA (*(vuint8*)0x4202)
+#define REG_WRMPYB (*(vuint8*)0x4203)
+#define REG_WRDIVL (*(vuint8*)0x4204)
+#define REG_WRDIVH (*(vuint8*)0x4205)
+#define REG_WRDIVB (*(vuint8*)0x4206)
+#define REG_RDDIVL (*(vuint8*)0x4214)
+#define REG_RDDIVH (*(vuint8*)0x4215)
+#define REG_RDMPYL (*(vuint8*)0x4216)
+#define REG_RDMPYH (*(vuint8*)0x4217)
+#endif
+
+#ifndef REG_M7A
+#define REG_M7A (*(vuint8*)0x211B)
+#define REG_M7B (*(vuint8*)0x211C)
+#define REG_MPYL (*(vuint8*)0x2134)
+#define REG_MPYM (*(vuint8*)0x2135)
+#define REG_MPYH (*(vuint8*)0x2136)
+#endif
+
+// Start an unsigned 8x8 multiply; read the product with HW_MUL8_RESULT()
+// at least 8 cycles later
+#ifdef HOST_BUILD
+// Host build (host/): no multiplier, the product is computed in place
+extern u16 g_hwMulResult;
+#define HW_MUL8(a, b) \
+    do { g_hwMulResult = (u16)((u8)(a) * (u8)(b)); } while (0)
+#define HW_MUL8_RESULT() (g_hwMulResult)
+#else
+#define HW_MUL8(a, b) \
+    do { REG_WRMPYA = (u8)(a); REG_WRMPYB = (u8)(b); } while (0)
+#define HW_MUL8_RESULT() ((u16)(REG_RDMPYL | ((u16)REG_RDMPYH << 8)))
+#endif
+
+// Unsigned 8x8 -> 16
+u16 hw_mul8(u8 a, u8 b);
+
+// Unsigned 16/8 -> 16. Division by zero returns 0xFFFF (hardware behaviour).
+u16 hw_div(u16 a, u8 b);
+u16 hw_mod(u16 a, u8 b);
+
+// Map a random value onto [0, n) with a multiply instead of a modulo.
+// Uses the high byte of r, so the low bits stay free for other choices.
+u8 hw_range(u16 r, u8 n);
+
+// Signed 16 x 8 -> low 16 bits of the product, via the PPU multiplier
+s16 hw_mul_s16_s8(s16 a, s8 b);
+
+// 8.8 fixed-point multiply: (a * b) >> 8
+s16 fx_mul(s16 a, s16 b);
+
+#endif
@@ -0,0 +1,89 @@
+#include <snes.h>
+
+#include "jobs.h"
+#include "prof.h"
+
+#define JOBS_NMI_LINE 225
+
+u16 g_jobSteps;
+u8 g_jobsPending;
+
+// Queued jobs, dense and in queue order
+static JobFn s_fn[JOB_MAX];
+static u16 s_step[JOB_MAX];
+static u8 s_prio[JOB_MAX];
+
+static s8 find_job(JobFn fn) {
+    u8 i;
+
+    for (i = 0; i < g_jobsPending; i++) {
+        if (s_fn[i] == fn) return (s8)i;
+    }
+    return -1;
+}
+
+static void remove_job(u8 i) {
+    g_jobsPending--;
+    for (; i < g_jobsPending; i++) {
+        s_fn[i] = s_fn[i + 1];
+        s_step[i] = s_step[i + 1];
+        s_prio[i] = s_prio[i + 1];
+    }
+}
+
+// Run one step of job i; returns nonzero if that was its last
+static u8 run_step(u8 i) {
+    g_jobSteps++;
+    if (s_fn[i](s_step[i]++) == JOB_DONE) {
+        remove_job(i);
+        return 1;
+    }
+    return 0;
+}
+
+u8 jobs_add(JobFn fn, u8 prio) {
+    u8 n;
+
+    if (find_job(fn) >= 0) return 1;
+    if (g_jobsPending == JOB_MAX) return 0;
+
+    n = g_jobsPending++;
+    s_fn[n] = fn;
+    s_step[n] = 0;
+    s_prio[n] = prio;
+    return 1;
+}
+
+void jobs_finish(JobFn fn) {
+    s8 i = find_job(fn);
+
+    if (i < 0) return;
+    while (!run_step((u8)i)) {
+    }
+}
+
+void jobs_run(u16 frame_vblank) {
+    u8 i, best;
+#ifndef HOST_BUILD
+    u16 line;
+#endif
+
+    g_jobSteps = 0;
+    while (g_jobsPending) {
+#ifndef HOST_BUILD
+        // Lines past JOBS_NMI_LINE with no NMI yet are the VBlank this
+        // frame started in, not the end of it
+        if (snes_vblank_count != frame_vblank) break;
+        line = prof_line();
+        if (line >= JOBS_DEADLINE_LINE && line < JOBS_NMI_LINE) break;
+#else
+        (void)frame_vblank;
+#endif
+
+        best = 0;
+        for (i = 1; i < g_jobsPending; i++) {
+            if (s_prio[i] > s_prio[best]) best = i;
+        }
+        run_step(best);
+    }
+}
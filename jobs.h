@@ -0,0 +1,44 @@
+#ifndef STARSHMUP_JOBS_H
+#define STARSHMUP_JOBS_H
+
+#include <snes.h>
+
+// Cooperative jobs for the idle time between the frame's work and VBlank.
+//
+// A job is a function run in resumable steps: jobs_run() calls the
+// highest-priority queued job with its step number (0, 1, ...) until it
+// returns JOB_DONE, and yields once the V counter reaches
+// JOBS_DEADLINE_LINE. A step is never cut short, so steps should be small;
+// whatever is left runs in later frames. The host build has no V counter
+// and runs every queued job to completion.
+#define JOB_MAX 8
+#define JOBS_DEADLINE_LINE 216  // Leaves a few lines before the NMI at 225
+
+#define JOB_DONE 0
+#define JOB_MORE 1
+
+// Higher runs first; equal priorities run in queue order
+#define JOB_PRIO_LOW 0
+#define JOB_PRIO_NORMAL 1
+#define JOB_PRIO_HIGH 2
+
+typedef u8 (*JobFn)(u16 step);
+
+// Steps run by the last jobs_run(), and jobs still queued
+extern u16 g_jobSteps;
+extern u8 g_jobsPending;
+
+// Queue a job. A job already queued is left as it is. Returns 0 if the
+// queue is full.
+u8 jobs_add(JobFn fn, u8 prio);
+
+// Run a queued job's remaining steps now, e.g. before drawing over what it
+// touches
+void jobs_finish(JobFn fn);
+
+// Run jobs until the deadline. frame_vblank is snes_vblank_count at the
+// start of the frame; if a VBlank has passed since, the frame is already
+// late and nothing runs.
+void jobs_run(u16 frame_vblank);
+
+#endif
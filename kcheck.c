@@ -0,0 +1,178 @@
+#include <snes.h>
+
+#include "bullets.h"
+#include "collide.h"
+#include "enemies.h"
+#include "game.h"
+#include "kcheck.h"
+
+#ifdef KERNEL_CHECK
+
+KernelCheck g_kernelCheck;
+
+// Own generator (xorshift16), so g_rng is left alone
+static u16 s_seed = 0x1D2Bu;
+
+// Bullet pool state before the step, and after the C version
+static Bullet s_inBullets[MAX_BULLETS];
+static u8 s_inLive[MAX_BULLETS];
+static u8 s_inFree[MAX_BULLETS];
+static u8 s_inCount, s_inFreeCount;
+static Bullet s_cBullets[MAX_BULLETS];
+static u8 s_cLive[MAX_BULLETS];
+static u8 s_cFree[MAX_BULLETS];
+static u8 s_cCount, s_cFreeCount;
+
+static u16 next(void) {
+    s_seed ^= s_seed << 7;
+    s_seed ^= s_seed >> 9;
+    s_seed ^= s_seed << 8;
+    return s_seed;
+}
+
+// Mostly near the visible area, so the edges get exercised; now and then
+// anywhere in the s16 range
+static s16 next_coord(void) {
+    u16 r = next();
+
+    if ((r & 0x0F) == 0) return (s16)next();
+    return (s16)(r & 0x01FF) - 64;
+}
+
+static void copy_bytes(u8* dst, const u8* src, u16 size) {
+    while (size--) *dst++ = *src++;
+}
+
+static u8 same_bytes(const u8* a, const u8* b, u16 size) {
+    while (size--) {
+        if (*a++ != *b++) return 0;
+    }
+    return 1;
+}
+
+static void save_pool(Bullet* bullets, u8* live, u8* free_slots, u8* count, u8* free_count) {
+    copy_bytes((u8*)bullets, (const u8*)g_bullets, sizeof(g_bullets));
+    copy_bytes(live, g_bulletLive, MAX_BULLETS);
+    copy_bytes(free_slots, g_bulletFree, MAX_BULLETS);
+    *count = g_bulletCount;
+    *free_count = g_bulletFreeCount;
+}
+
+static void load_pool(const Bullet* bullets, const u8* live, const u8* free_slots, u8 count,
+                      u8 free_count) {
+    copy_bytes((u8*)g_bullets, (const u8*)bullets, sizeof(g_bullets));
+    copy_bytes(g_bulletLive, live, MAX_BULLETS);
+    copy_bytes(g_bulletFree, free_slots, MAX_BULLETS);
+    g_bulletCount = count;
+    g_bulletFreeCount = free_count;
+}
+
+// Random live set: spawn some bullets, kill a few to shuffle the free
+// stack, then give each slot random velocity and sub-pixels
+static u8 check_bullets(void) {
+    u8 i, spawn;
+    Bullet* b;
+
+    bullets_clear();
+    spawn = (u8)(next() % (MAX_BULLETS + 1));
+    for (i = 0; i < spawn; i++) {
+        bullets_spawn(next_coord(), next_coord(), (s16)next(), (s16)next());
+    }
+    for (i = (u8)(next() & 7); i && g_bulletCount; i--) {
+        bullets_kill((u8)(next() % g_bulletCount));
+    }
+    for (i = 0; i < MAX_BULLETS; i++) {
+        b = &g_bullets[i];
+        b->fx = (u8)next();
+        b->fy = (u8)next();
+    }
+
+    save_pool(s_inBullets, s_inLive, s_inFree, &s_inCount, &s_inFreeCount);
+    bullets_step_c();
+    save_pool(s_cBullets, s_cLive, s_cFree, &s_cCount, &s_cFreeCount);
+    load_pool(s_inBullets, s_inLive, s_inFree, s_inCount, s_inFreeCount);
+    bullets_step_asm();
+
+    return g_bulletCount == s_cCount && g_bulletFreeCount == s_cFreeCount &&
+           same_bytes((const u8*)g_bullets, (const u8*)s_cBullets, sizeof(g_bullets)) &&
+           same_bytes(g_bulletLive, s_cLive, MAX_BULLETS) &&
+           same_bytes(g_bulletFree, s_cFree, MAX_BULLETS);
+}
+
+// Random enemies clustered around (bx, by) so hits and misses on either
+// axis both come up, and a random g_collideList. A few sit exactly $8000
+// away on one axis, where iabs_s16() leaves -32768 and the box test passes.
+static void put_enemies(s16 bx, s16 by) {
+    u8 i, r;
+
+    for (i = 0; i < MAX_ENEMIES; i++) {
+        r = (u8)(next() & 15);
+        if (r < 2) {
+            g_enemyX[i] = next_coord();
+            g_enemyY[i] = next_coord();
+        } else if (r == 2) {
+            g_enemyX[i] = (s16)(bx ^ 0x8000);
+            g_enemyY[i] = by + (s16)(next() & 0x1F) - 16;
+        } else if (r == 3) {
+            g_enemyX[i] = bx + (s16)(next() & 0x1F) - 16;
+            g_enemyY[i] = (s16)(by ^ 0x8000);
+        } else {
+            g_enemyX[i] = bx + (s16)(next() & 0x3F) - 32;
+            g_enemyY[i] = by + (s16)(next() & 0x3F) - 32;
+        }
+        g_collideList[i] = (u8)(next() % MAX_ENEMIES);
+    }
+}
+
+static u8 check_collide(void) {
+    const s16 bx = next_coord();
+    const s16 by = next_coord();
+    u16 first, n;
+
+    put_enemies(bx, by);
+    n = next() % (MAX_ENEMIES + 1);
+    first = next() % (n + 1);
+
+    return collide_scan_c(bx, by, first, n) == collide_scan_asm(bx, by, first, n);
+}
+
+// The player box is read from g_game, which is restored afterwards
+static u8 check_player_scan(void) {
+    const s16 px = g_game.player_x;
+    const s16 py = g_game.player_y;
+    u16 first, n;
+    u8 same;
+
+    g_game.player_x = next_coord();
+    g_game.player_y = next_coord();
+    put_enemies(g_game.player_x, g_game.player_y);
+    n = next() % (MAX_ENEMIES + 1);
+    first = next() % (n + 1);
+
+    same = collide_player_scan_c(first, n) == collide_player_scan_asm(first, n);
+    g_game.player_x = px;
+    g_game.player_y = py;
+    return same;
+}
+
+void kcheck_run(void) {
+    u16 r;
+
+    g_kernelCheck.magic[0] = 'K';
+    g_kernelCheck.magic[1] = 'C';
+    g_kernelCheck.magic[2] = 'H';
+    g_kernelCheck.magic[3] = 'K';
+
+    for (r = 0; r < KCHECK_ROUNDS; r++) {
+        if (!check_bullets()) g_kernelCheck.bullet_fails++;
+        if (!check_collide()) g_kernelCheck.collide_fails++;
+        if (!check_player_scan()) g_kernelCheck.player_fails++;
+        g_kernelCheck.rounds++;
+    }
+
+    bullets_clear();
+    enemies_clear();
+    g_kernelCheck.done = 1;
+}
+
+#endif
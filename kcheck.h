@@ -0,0 +1,30 @@
+#ifndef STARSHMUP_KCHECK_H
+#define STARSHMUP_KCHECK_H
+
+#include <snes.h>
+
+// Kernel check builds (`make KERNEL_CHECK=1`): at boot, run the asm
+// kernels (kernels.asm) and their C references on the same pseudo-random
+// inputs and count any difference in their results. The game then starts
+// as usual; read g_kernelCheck from WRAM like g_bench. `make host
+// KERNEL_CHECK=1` runs the same check with the asm on a 65816 simulator.
+#define KCHECK_ROUNDS 1000
+
+#ifdef KERNEL_CHECK
+
+typedef struct KernelCheck {
+    char magic[4];      // "KCHK"
+    u8 done;            // Set once all rounds have run
+    u16 rounds;         // Rounds run per kernel
+    u16 bullet_fails;   // bullets_step_asm() rounds that differed
+    u16 collide_fails;  // collide_scan_asm() rounds that differed
+    u16 player_fails;   // collide_player_scan_asm() rounds that differed
+} KernelCheck;
+
+extern KernelCheck g_kernelCheck;
+
+void kcheck_run(void);
+
+#endif
+
+#endif
@@ -0,0 +1,307 @@
+;---------------------------------------------------------------------------
+; Hand-written versions of the hottest gameplay loops, used by ASM_KERNELS
+; builds in place of bullets_step_c() (bullets.c), collide_scan_c() and
+; collide_player_scan_c() (collide.c). Those stay as the reference: results
+; must match them exactly, which `make KERNEL_CHECK=1` checks (kcheck.c);
+; `make host KERNEL_CHECK=1` runs the same check on a 65816 simulator
+; (host/sim65.c).
+;
+; All run with 16-bit index registers and switch the accumulator between
+; 8 bits (sub-pixels, list entries, counts) and 16 bits (positions). The
+; data bank is set to the WRAM bank of the C globals for the whole call.
+; D points at the gameplay state's page (game_dp.asm) for the whole call,
+; and is restored on return: the player position and the kernels' scratch
+; are one-byte direct-page operands there, with no DL penalty. PVSnesLib's
+; VBlank handler saves D and loads its own before running any C, so an NMI
+; taken inside a kernel does not see this one.
+;---------------------------------------------------------------------------
+
+.include "hdr.asm"
+
+; Must match game.h / bullets.h
+.DEFINE SCREEN_W                256
+.DEFINE SCREEN_H                224
+.DEFINE BULLET_SIZE             8
+.DEFINE BULLET_COLLISION_RADIUS 12     ; (BULLET_SIZE + ENEMY_SIZE) / 2
+.DEFINE PLAYER_COLLISION_RADIUS 16     ; (PLAYER_SIZE + ENEMY_SIZE) / 2
+.DEFINE COLLIDE_NONE            $FF
+
+; struct Bullet
+.DEFINE B_X     0
+.DEFINE B_Y     2
+.DEFINE B_VX    4
+.DEFINE B_VY    6
+.DEFINE B_FX    8
+.DEFINE B_FY    9
+
+; Direct page, with D = g_game: GameState fields (game.h) ...
+.DEFINE G_PLAYER_X  0
+.DEFINE G_PLAYER_Y  2
+; ... and scratch from GAME_DP_SCRATCH
+.DEFINE K_TMP       $F0     ; Slot offset / velocity high byte, sign-extended
+.DEFINE K_BX        $F2
+.DEFINE K_BY        $F4
+.DEFINE K_N         $F6
+
+.SECTION ".kernels_text" SUPERFREE
+
+; Save P, DB and D, and point D at the gameplay state's page. Leaves A and
+; index registers 16-bit.
+.MACRO KERNEL_ENTER
+    php
+    phb
+    phd
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda #g_game
+    tcd
+.ENDM
+
+; FX_STEP(pos, frac, vel) on the bullet at X: frac += vel low byte, then
+; pos += sign-extended vel high byte plus the carry. Accumulator 16-bit on
+; entry and exit, leaving the new pos in A.
+.MACRO BULLET_FX_STEP ARGS POS, FRAC, VEL
+    .ACCU 16
+    lda g_bullets+VEL,x
+    xba
+    and #$00FF
+    cmp #$0080
+    bcc _pos\@
+    ora #$FF00
+_pos\@:
+    sta.b K_TMP
+    sep #$20
+    .ACCU 8
+    lda g_bullets+FRAC,x
+    clc
+    adc g_bullets+VEL,x
+    sta g_bullets+FRAC,x
+    rep #$20            ; REP/SEP leave the carry alone
+    .ACCU 16
+    lda g_bullets+POS,x
+    adc.b K_TMP
+    sta g_bullets+POS,x
+.ENDM
+
+;---------------------------------------------------------------------------
+; void bullets_step_asm(void)
+;
+; The off-screen test is one unsigned compare per axis: for any s16 p,
+; -BULLET_SIZE <= p <= LIMIT + BULLET_SIZE exactly when
+; (u16)(p + BULLET_SIZE) <= LIMIT + 2 * BULLET_SIZE.
+bullets_step_asm:
+    KERNEL_ENTER
+
+    sep #$20
+    .ACCU 8
+    lda #:g_bullets
+    pha
+    plb
+    ldy #0              ; Y = n, position in the live list
+
+_bs_next:
+    sep #$20
+    .ACCU 8
+    tya
+    cmp g_bulletCount
+    bcc _bs_live
+    jmp _bs_done
+
+_bs_live:
+    lda g_bulletLive,y
+    rep #$20
+    .ACCU 16
+    and #$00FF
+    asl a
+    sta.b K_TMP
+    asl a
+    asl a
+    clc
+    adc.b K_TMP
+    tax                 ; X = slot * sizeof(Bullet)
+
+    BULLET_FX_STEP B_X, B_FX, B_VX
+    BULLET_FX_STEP B_Y, B_FY, B_VY
+
+    clc
+    adc #BULLET_SIZE
+    cmp #SCREEN_H + 2 * BULLET_SIZE + 1
+    bcs _bs_kill
+    lda g_bullets+B_X,x
+    clc
+    adc #BULLET_SIZE
+    cmp #SCREEN_W + 2 * BULLET_SIZE + 1
+    bcs _bs_kill
+    iny
+    jmp _bs_next
+
+    ; bullets_kill(n): the last live entry moves into position n and the
+    ; slot goes back on the free stack; n stays put
+_bs_kill:
+    .ACCU 16
+    sep #$20
+    .ACCU 8
+    lda g_bulletLive,y
+    pha                 ; Killed slot
+    dec g_bulletCount
+    rep #$20
+    .ACCU 16
+    lda g_bulletCount
+    and #$00FF
+    tax
+    sep #$20
+    .ACCU 8
+    lda g_bulletLive,x
+    sta g_bulletLive,y
+    rep #$20
+    .ACCU 16
+    lda g_bulletFreeCount
+    and #$00FF
+    tax
+    sep #$20
+    .ACCU 8
+    pla
+    sta g_bulletFree,x
+    inc g_bulletFreeCount
+    jmp _bs_next
+
+_bs_done:
+    pld
+    plb
+    plp
+    rtl
+
+; Box scan over g_collideList shared by the two collision kernels. On entry
+; Y = first list position, K_N = n, DB = bank of g_enemyX, A 8-bit. Leaves
+; in A (16-bit) the position of the first enemy whose top-left is within
+; RADIUS of the words at direct-page offsets PX / PY on both axes, or
+; COLLIDE_NONE.
+;
+; iabs_s16(-32768) is still -32768 in C, which is below the radius as a
+; signed compare, so a difference of $8000 counts as within range.
+.MACRO BOX_SCAN ARGS PX, PY, RADIUS
+_next\@:
+    .ACCU 8
+    tya
+    cmp.b K_N
+    bcs _none\@
+    lda g_collideList,y
+    rep #$20
+    .ACCU 16
+    and #$00FF
+    asl a
+    tax                 ; X = e * 2
+
+    lda.b PX
+    sec
+    sbc g_enemyX,x
+    bpl _xabs\@
+    eor #$FFFF
+    inc a
+_xabs\@:
+    cmp #RADIUS
+    bcc _xin\@
+    cmp #$8000
+    bne _miss\@
+_xin\@:
+    lda.b PY
+    sec
+    sbc g_enemyY,x
+    bpl _yabs\@
+    eor #$FFFF
+    inc a
+_yabs\@:
+    cmp #RADIUS
+    bcc _hit\@
+    cmp #$8000
+    beq _hit\@
+
+_miss\@:
+    sep #$20
+    .ACCU 8
+    iny
+    bra _next\@
+
+_hit\@:
+    .ACCU 16
+    tya
+    bra _done\@
+
+_none\@:
+    .ACCU 8
+    rep #$20
+    .ACCU 16
+    lda #COLLIDE_NONE
+_done\@:
+.ENDM
+
+;---------------------------------------------------------------------------
+; u8 collide_scan_asm(s16 bx, s16 by, u16 first, u16 n)
+;
+; Arguments as pushed by 816-tcc (see lz.asm): all four are 16-bit, so with
+; P, DB and D pushed bx is at 8,s, by at 10,s, first at 12,s and n at 14,s
+; (only its low byte is used). The result (a list position) goes back in
+; tcc__r0.
+collide_scan_asm:
+    KERNEL_ENTER
+
+    lda 8,s
+    sta.b K_BX
+    lda 10,s
+    sta.b K_BY
+    sep #$20
+    .ACCU 8
+    lda 14,s
+    sta.b K_N
+    rep #$20
+    .ACCU 16
+    lda 12,s
+    and #$00FF
+    tay                 ; Y = position in g_collideList
+    sep #$20
+    .ACCU 8
+    lda #:g_enemyX
+    pha
+    plb
+
+    BOX_SCAN K_BX, K_BY, BULLET_COLLISION_RADIUS
+
+    pld
+    plb
+    sta.l tcc__r0       ; Absolute long: DB is not assumed here
+    plp
+    rtl
+
+;---------------------------------------------------------------------------
+; u8 collide_player_scan_asm(u16 first, u16 n)
+;
+; collide_scan_asm() for the player box, read straight from g_game through
+; the direct page. first is at 8,s and n at 10,s.
+collide_player_scan_asm:
+    KERNEL_ENTER
+
+    sep #$20
+    .ACCU 8
+    lda 10,s
+    sta.b K_N
+    rep #$20
+    .ACCU 16
+    lda 8,s
+    and #$00FF
+    tay                 ; Y = position in g_collideList
+    sep #$20
+    .ACCU 8
+    lda #:g_enemyX
+    pha
+    plb
+
+    BOX_SCAN G_PLAYER_X, G_PLAYER_Y, PLAYER_COLLISION_RADIUS
+
+    pld
+    plb
+    sta.l tcc__r0
+    plp
+    rtl
+
+.ENDS
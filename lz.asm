@@ -0,0 +1,174 @@
+;---------------------------------------------------------------------------
+; LZSS decompressor writing straight to VRAM (format: tools/gfxconv.c)
+;
+; Back-references reach at most 256 bytes back, so the last 256 output
+; bytes are kept in a WRAM ring indexed by the output position; VRAM is
+; never read back. Output bytes alternate between $2118 and $2119 with
+; VMAIN incrementing after the high byte, so the output position's low bit
+; selects the port.
+;
+; The data bank is switched to the source blob's bank for the whole run.
+; Every ROM bank in this LoROM, including the $80+ mirrors a FastROM build
+; links at, maps low WRAM ($0000-$1FFF) and the PPU registers too, so the
+; ring, the variables and $2118/$2119 stay reachable with absolute
+; addressing.
+;---------------------------------------------------------------------------
+
+.include "hdr.asm"
+
+.RAMSECTION ".reg_lz" BANK 0 SLOT 1
+lz_ring     dsb 256     ; Last 256 output bytes
+lz_left     dsw 1       ; Output bytes still to produce
+lz_count    dsw 1       ; Bytes left in the current match
+lz_flags    db          ; Token flags, shifted out bit 0 first
+lz_bits     db          ; Tokens left under lz_flags
+lz_dist     db          ; Match distance - 1
+.ENDS
+
+.SECTION ".lz_text" SUPERFREE
+
+; Write A (8-bit) to the ring and VRAM at output position X, then advance X
+.MACRO LZ_PUT
+    sta lz_ring,x
+    pha
+    txa
+    lsr a               ; Carry = odd position
+    pla
+    bcs _odd\@
+    sta $2118
+    bra _next\@
+_odd\@:
+    sta $2119
+_next\@:
+    inx
+    cpx #$0100
+    bne _keep\@
+    ldx #0
+_keep\@:
+.ENDM
+
+;---------------------------------------------------------------------------
+; void lz_to_vram(const u8* src, u16 vram_addr)
+;
+; 816-tcc pushes arguments right to left, a pointer as its low word then
+; its bank; after JSL they start at 4,s. 16-bit arguments take a word each
+; but u8 ones only a byte, so asm entry points take u16 where C would use
+; u8. With P and DB pushed below: src low word at 6,s, src bank at 8,s,
+; vram_addr at 10,s.
+lz_to_vram:
+    php
+    phb
+
+    rep #$30
+    .ACCU 16
+    .INDEX 16
+    lda 10,s
+    sta.l $2116         ; VMADD
+    lda 6,s
+    tay                 ; Y = source address within its bank
+
+    sep #$20
+    .ACCU 8
+    lda 8,s
+    pha
+    plb                 ; DB = source bank
+    lda #$80
+    sta $2115           ; VMAIN: increment after $2119
+
+    rep #$20
+    .ACCU 16
+    lda $0000,y         ; Header: output size
+    sta lz_left
+    iny
+    iny
+    ldx #0              ; Output position mod 256
+    sep #$20
+    .ACCU 8
+    stz lz_bits
+
+_token:
+    rep #$20
+    .ACCU 16
+    lda lz_left
+    beq _done
+    sep #$20
+    .ACCU 8
+
+    lda lz_bits
+    bne _have_flags
+    lda $0000,y         ; Next flag byte
+    iny
+    sta lz_flags
+    lda #8
+_have_flags:
+    dec a
+    sta lz_bits
+    lsr lz_flags
+    bcs _match
+
+    ; Literal
+    lda $0000,y
+    iny
+    LZ_PUT
+    rep #$20
+    .ACCU 16
+    dec lz_left
+    bra _token
+
+_match:
+    .ACCU 8
+    lda $0000,y
+    sta lz_dist
+    lda $0001,y         ; Length - 3
+    iny
+    iny
+    rep #$20
+    .ACCU 16
+    and #$00FF
+    clc
+    adc #3
+    sta lz_count
+    lda lz_left
+    sec
+    sbc lz_count
+    sta lz_left
+
+    ; Y = ring read position = X - distance (mod 256); clc makes sbc
+    ; subtract one more than lz_dist
+    phy
+    sep #$20
+    .ACCU 8
+    txa
+    clc
+    sbc lz_dist
+    rep #$20
+    .ACCU 16
+    and #$00FF
+    tay
+    sep #$20
+    .ACCU 8
+
+_copy:
+    lda lz_ring,y
+    iny
+    cpy #$0100
+    bne _copy_put
+    ldy #0
+_copy_put:
+    LZ_PUT
+    rep #$20
+    .ACCU 16
+    dec lz_count
+    sep #$20
+    .ACCU 8
+    bne _copy           ; SEP leaves Z from the decrement
+
+    ply
+    bra _token
+
+_done:
+    plb
+    plp
+    rtl
+
+.ENDS
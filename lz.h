@@ -0,0 +1,14 @@
+#ifndef STARSHMUP_LZ_H
+#define STARSHMUP_LZ_H
+
+#include <snes.h>
+
+// LZSS-compressed blobs (tools/gfxconv.c -l): a u16 output size, then a
+// flag byte per 8 tokens, each a literal byte or a (distance - 1,
+// length - 3) pair reaching at most 256 bytes back.
+
+// Decompress src straight into VRAM from word address vram_addr, in 65816
+// assembly (lz.asm). Forced blank only. The blob must not cross a bank.
+void lz_to_vram(const u8* src, u16 vram_addr);
+
+#endif
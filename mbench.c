@@ -0,0 +1,124 @@
+#include <snes.h>
+
+#include "hwmath.h"
+#include "mbench.h"
+#include "prof.h"
+
+#ifdef MATH_BENCH
+
+MathBench g_mathBench;
+
+// Own generator (xorshift16), so g_rng is left alone. Reset before each
+// timed path, so every path sees the same inputs.
+static u16 s_seed;
+
+// One batch of inputs; divisors are never 0
+static u16 s_a[MBENCH_BATCH];
+static u8 s_b[MBENCH_BATCH];
+static s16 s_fa[MBENCH_BATCH];
+static s16 s_fb[MBENCH_BATCH];
+
+// Results are stored here so no path can be dropped
+static u16 s_sink;
+
+static u16 s_lines;
+static u16 s_start;
+
+static u16 next(void) {
+    s_seed ^= s_seed << 7;
+    s_seed ^= s_seed >> 9;
+    s_seed ^= s_seed << 8;
+    return s_seed;
+}
+
+static void fill_inputs(void) {
+    u8 i;
+
+    for (i = 0; i < MBENCH_BATCH; i++) {
+        s_a[i] = next();
+        s_b[i] = (u8)next() | 1;
+        s_fa[i] = (s16)next();
+        s_fb[i] = (s16)next();
+    }
+}
+
+// New inputs outside the timing, then start on a fresh frame so a batch
+// never spans more than one V counter wrap
+static void batch_begin(void) {
+    fill_inputs();
+    WaitForVBlank();
+    s_start = prof_line();
+}
+
+static void batch_end(void) {
+    u16 line = prof_line();
+
+    if (line < s_start) line += PROF_FRAME_LINES;
+    s_lines += line - s_start;
+}
+
+// Scanlines for MBENCH_CALLS evaluations of expr over the inputs (index i)
+#define MBENCH_TIMER(name, expr)                         \
+    static u16 name(void) {                              \
+        u8 k, i;                                         \
+        s_seed = 0x1D2Bu;                                \
+        s_lines = 0;                                     \
+        for (k = 0; k < MBENCH_BATCHES; k++) {           \
+            batch_begin();                               \
+            for (i = 0; i < MBENCH_BATCH; i++) {         \
+                s_sink = (u16)(expr);                    \
+            }                                            \
+            batch_end();                                 \
+        }                                                \
+        return s_lines;                                  \
+    }
+
+MBENCH_TIMER(time_base, s_a[i])
+MBENCH_TIMER(time_soft_mul, (u8)s_a[i] * s_b[i])
+MBENCH_TIMER(time_hw_mul, hw_mul8((u8)s_a[i], s_b[i]))
+MBENCH_TIMER(time_soft_div, s_a[i] / s_b[i])
+MBENCH_TIMER(time_hw_div, hw_div(s_a[i], s_b[i]))
+MBENCH_TIMER(time_soft_mod, s_a[i] % s_b[i])
+MBENCH_TIMER(time_hw_mod, hw_mod(s_a[i], s_b[i]))
+MBENCH_TIMER(time_soft_fx, ((s32)s_fa[i] * s_fb[i]) >> 8)
+MBENCH_TIMER(time_hw_fx, fx_mul(s_fa[i], s_fb[i]))
+
+static u16 count_mismatches(void) {
+    u16 fails = 0;
+    u8 k, i;
+
+    s_seed = 0x1D2Bu;
+    for (k = 0; k < MBENCH_BATCHES; k++) {
+        fill_inputs();
+        for (i = 0; i < MBENCH_BATCH; i++) {
+            if (hw_mul8((u8)s_a[i], s_b[i]) != (u16)((u8)s_a[i] * s_b[i])) fails++;
+            if (hw_div(s_a[i], s_b[i]) != (u16)(s_a[i] / s_b[i])) fails++;
+            if (hw_mod(s_a[i], s_b[i]) != (u16)(s_a[i] % s_b[i])) fails++;
+            if (fx_mul(s_fa[i], s_fb[i]) != (s16)(((s32)s_fa[i] * s_fb[i]) >> 8)) fails++;
+        }
+    }
+    return fails;
+}
+
+void mbench_run(void) {
+    g_mathBench.magic[0] = 'M';
+    g_mathBench.magic[1] = 'B';
+    g_mathBench.magic[2] = 'C';
+    g_mathBench.magic[3] = 'H';
+    g_mathBench.calls = MBENCH_CALLS;
+
+    g_mathBench.base = time_base();
+    g_mathBench.mul.soft = time_soft_mul();
+    g_mathBench.mul.hw = time_hw_mul();
+    g_mathBench.div.soft = time_soft_div();
+    g_mathBench.div.hw = time_hw_div();
+    g_mathBench.mod.soft = time_soft_mod();
+    g_mathBench.mod.hw = time_hw_mod();
+    g_mathBench.fx.soft = time_soft_fx();
+    g_mathBench.fx.hw = time_hw_fx();
+    g_mathBench.mismatches = count_mismatches();
+
+    g_mathBench.done = 1;
+}
+
+#endif
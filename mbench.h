@@ -0,0 +1,46 @@
+#ifndef STARSHMUP_MBENCH_H
+#define STARSHMUP_MBENCH_H
+
+#include <snes.h>
+
+// Math bench builds (`make MATH_BENCH=1`): at boot, time the compiler's
+// software multiply/divide (tcc__mul, tcc__udiv, ...) against the hwmath.h
+// routines that replace them, on the same pseudo-random inputs, and check
+// that both give the same results. The game then starts as usual; read
+// g_mathBench from WRAM like g_bench.
+//
+// Each path runs MBENCH_CALLS times in batches of MBENCH_BATCH, each batch
+// starting right after VBlank and timed in scanlines with prof_line(). The
+// same loop storing a plain load is timed as `base`; per call, a path costs
+// about (lines - base) * 1364 / MBENCH_CALLS master cycles (1364 per line).
+#define MBENCH_BATCH 16
+#define MBENCH_BATCHES 16
+#define MBENCH_CALLS (MBENCH_BATCH * MBENCH_BATCHES)
+
+#ifdef MATH_BENCH
+
+// Scanlines spent on MBENCH_CALLS calls of each path
+typedef struct MathBenchOp {
+    u16 soft;  // Plain C operator, compiled to a tcc__ library call
+    u16 hw;    // hwmath.h replacement
+} MathBenchOp;
+
+typedef struct MathBench {
+    char magic[4];    // "MBCH"
+    u8 done;          // Set once every path has been timed
+    u16 calls;        // MBENCH_CALLS
+    u16 base;         // Loop overhead, to subtract from the others
+    MathBenchOp mul;  // a * b (u8 x u8) vs hw_mul8()
+    MathBenchOp div;  // a / b (u16 / u8) vs hw_div()
+    MathBenchOp mod;  // a % b (u16 % u8) vs hw_mod()
+    MathBenchOp fx;   // ((s32)a * b) >> 8 vs fx_mul()
+    u16 mismatches;   // Inputs where the two paths disagreed; should be 0
+} MathBench;
+
+extern MathBench g_mathBench;
+
+void mbench_run(void);
+
+#endif
+
+#endif
@@ -0,0 +1,235 @@
+#include <snes.h>
+#include <string.h>
+
+#include "game.h"
+#include "oam.h"
+
+// Y for hidden objects: below the 224-line display for 8x8 and 16x16 objects
+#define OAM_HIDDEN_Y 240
+#define OAM_HI_TABLE 512
+
+// OAM slots for the rotating region, and groups of 4 in it and the stage
+#define STAGE_SLOTS (OAM_SLOTS - OAM_PRIORITY_SLOTS)
+#define STAGE_GROUPS (STAGE_SLOTS / 4)
+#define STAGE_MAX_GROUPS (OAM_STAGE_MAX / 4)
+
+u8 g_oamOverLines = 0;
+u16 g_oamDropped = 0;
+
+// Priority region, written in place
+static u8 s_prioNext = 0;
+static u8 s_prioShown = 0;
+static u8 s_prioHi = 0;
+
+// Rotating region, staged in OAM format (low table + packed high table)
+static u8 s_stage[OAM_STAGE_MAX * 4];
+static u8 s_stageHi[STAGE_MAX_GROUPS];
+static u16 s_stageNext = 0;
+static u8 s_stageHiAcc = 0;
+static u16 s_stageFull = 0;  // Pieces that did not fit in the stage
+
+// Slots possibly visible in oamMemory past the priority region
+static u8 s_shown = OAM_PRIORITY_SLOTS;
+// Rotation offset, in groups of 4 slots
+static u8 s_rot = 0;
+
+// High-table bits (bit 0 = X bit 8, bit 1 = large) shifted into place for
+// each of the 4 objects sharing a byte: [slot & 3][bits]
+static const u8 s_hiBits[4][4] = {
+    { 0x00, 0x01, 0x02, 0x03 },
+    { 0x00, 0x04, 0x08, 0x0C },
+    { 0x00, 0x10, 0x20, 0x30 },
+    { 0x00, 0x40, 0x80, 0xC0 },
+};
+
+// Writes one piece to lo[0..3]. Returns its high-table bits, or 0xFF if the
+// piece is fully off-screen and was not written.
+static u8 put_piece(u8* lo, const MetaspritePiece* p, s16 x, s16 y) {
+    const s16 px = x + p->dx;
+    const s16 py = y + p->dy;
+
+    if (px <= -16 || px >= SCREEN_W || py <= -16 || py >= SCREEN_H) return 0xFF;
+
+    lo[0] = (u8)px;
+    lo[1] = (u8)py;
+    lo[2] = p->tile;
+    lo[3] = p->attr;
+    return (u8)(((px >> 8) & 1) | (p->size << 1));
+}
+
+void oam_init(void) {
+    u16 i;
+    for (i = 0; i < OAM_SLOTS * 4; i += 4) {
+        oamMemory[i + 1] = OAM_HIDDEN_Y;
+    }
+    for (i = OAM_HI_TABLE; i < OAM_HI_TABLE + (OAM_SLOTS / 4); i++) {
+        oamMemory[i] = 0;
+    }
+    s_prioNext = 0;
+    s_prioShown = 0;
+    s_stageNext = 0;
+    s_stageFull = 0;
+    s_shown = OAM_PRIORITY_SLOTS;
+}
+
+void oam_begin(void) {
+    // Staged sprites never reached OAM; priority ones did and may need hiding
+    if (s_prioNext > s_prioShown) s_prioShown = s_prioNext;
+    s_prioNext = 0;
+    s_stageNext = 0;
+    s_stageFull = 0;
+}
+
+void oam_draw(const Metasprite* ms, s16 x, s16 y) {
+    const MetaspritePiece* p = ms->pieces;
+    u8 n = ms->count;
+    u8 bits, lane;
+
+    for (; n; n--, p++) {
+        if (s_stageNext >= OAM_STAGE_MAX) {
+            s_stageFull++;
+            continue;
+        }
+
+        bits = put_piece(&s_stage[s_stageNext << 2], p, x, y);
+        if (bits == 0xFF) continue;
+
+        lane = s_stageNext & 3;
+        if (lane == 0) s_stageHiAcc = 0;
+        s_stageHiAcc |= s_hiBits[lane][bits];
+        s_stageHi[s_stageNext >> 2] = s_stageHiAcc;
+        s_stageNext++;
+    }
+}
+
+void oam_draw_priority(const Metasprite* ms, s16 x, s16 y) {
+    const MetaspritePiece* p = ms->pieces;
+    u8 n = ms->count;
+    u8 bits, lane;
+
+    for (; n; n--, p++) {
+        if (s_prioNext >= OAM_PRIORITY_SLOTS) return;
+
+        bits = put_piece(&oamMemory[(u16)s_prioNext << 2], p, x, y);
+        if (bits == 0xFF) continue;
+
+        lane = s_prioNext & 3;
+        if (lane == 0) s_prioHi = 0;
+        s_prioHi |= s_hiBits[lane][bits];
+        oamMemory[OAM_HI_TABLE + (s_prioNext >> 2)] = s_prioHi;
+        s_prioNext++;
+    }
+}
+
+#ifdef OAM_LINE_STATS
+// Per-scanline sprite and tile counts, as difference arrays over the 256
+// possible Y positions (objects near Y=255 wrap to the top of the screen)
+static s16 s_lineSprites[256];
+static s16 s_lineTiles[256];
+
+// Size bit of each of the 4 objects sharing a high-table byte
+static const u8 s_sizeMask[4] = { 0x02, 0x08, 0x20, 0x80 };
+
+static void count_over_lines(u8 end) {
+    u8 i, y, h, tiles, over;
+    u16 line, stop;
+    s16 sprites_on, tiles_on;
+
+    for (i = 0; i < end; i++) {
+        y = oamMemory[((u16)i << 2) + 1];
+        if (y == OAM_HIDDEN_Y) continue;
+
+        if (oamMemory[OAM_HI_TABLE + (i >> 2)] & s_sizeMask[i & 3]) {
+            h = 16;
+            tiles = 2;
+        } else {
+            h = 8;
+            tiles = 1;
+        }
+
+        s_lineSprites[y]++;
+        s_lineTiles[y] += tiles;
+        stop = (u16)y + h;
+        if (stop < 256) {
+            s_lineSprites[stop]--;
+            s_lineTiles[stop] -= tiles;
+        } else {
+            // Wrapped part covers lines [0, stop - 256)
+            s_lineSprites[0]++;
+            s_lineTiles[0] += tiles;
+            s_lineSprites[stop - 256]--;
+            s_lineTiles[stop - 256] -= tiles;
+        }
+    }
+
+    over = 0;
+    sprites_on = 0;
+    tiles_on = 0;
+    for (line = 0; line < 256; line++) {
+        sprites_on += s_lineSprites[line];
+        tiles_on += s_lineTiles[line];
+        s_lineSprites[line] = 0;
+        s_lineTiles[line] = 0;
+        if (line < SCREEN_H &&
+            (sprites_on > OAM_LINE_MAX_SPRITES || tiles_on > OAM_LINE_MAX_TILES)) {
+            over++;
+        }
+    }
+    g_oamOverLines = over;
+}
+#endif
+
+void oam_end(void) {
+    u8 i, groups, shown, head, end, last;
+    u16 live = s_stageNext;
+
+    // Hide priority slots used last frame but not this one
+    for (i = s_prioNext; i < s_prioShown; i++) {
+        oamMemory[((u16)i << 2) + 1] = OAM_HIDDEN_Y;
+    }
+    s_prioShown = s_prioNext;
+
+    // Pad the staged list to whole groups so the rotated copy moves
+    // high-table bytes intact
+    while (s_stageNext & 3) {
+        s_stage[(s_stageNext << 2) + 1] = OAM_HIDDEN_Y;
+        s_stageNext++;
+    }
+
+    groups = (u8)(s_stageNext >> 2);
+    shown = (groups > STAGE_GROUPS) ? STAGE_GROUPS : groups;
+    g_oamDropped = s_stageFull;
+    if (groups) {
+        s_rot += OAM_ROTATE_STEP;
+        while (s_rot >= groups) s_rot -= groups;
+
+        // A window of `shown` staged groups from s_rot, wrapping to 0: all of
+        // them when they fit, otherwise a different subset every frame
+        head = groups - s_rot;
+        if (head > shown) head = shown;
+        memcpy(&oamMemory[OAM_PRIORITY_SLOTS * 4], &s_stage[(u16)s_rot << 4], (u16)head << 4);
+        memcpy(&oamMemory[OAM_PRIORITY_SLOTS * 4 + ((u16)head << 4)], s_stage,
+               (u16)(shown - head) << 4);
+        memcpy(&oamMemory[OAM_HI_TABLE + OAM_PRIORITY_SLOTS / 4], &s_stageHi[s_rot], head);
+        memcpy(&oamMemory[OAM_HI_TABLE + OAM_PRIORITY_SLOTS / 4 + head], s_stageHi, shown - head);
+
+        if (shown < groups) {
+            // Left out: everything past the window, less the padding if the
+            // last (padded) group is among the shown ones
+            last = groups - 1 - s_rot;
+            g_oamDropped += live - ((u16)shown << 2);
+            if (last < shown) g_oamDropped += s_stageNext - live;
+        }
+    }
+
+    // Hide rotating slots used last frame but not this one
+    end = OAM_PRIORITY_SLOTS + ((u16)shown << 2);
+    for (i = end; i < s_shown; i++) {
+        oamMemory[((u16)i << 2) + 1] = OAM_HIDDEN_Y;
+    }
+    s_shown = end;
+
+#ifdef OAM_LINE_STATS
+    count_over_lines(end);
+#endif
+}
@@ -0,0 +1,66 @@
+#ifndef STARSHMUP_OAM_H
+#define STARSHMUP_OAM_H
+
+#include <snes.h>
+
+// Metasprite renderer and OAM allocator over the shadow OAM (oamMemory).
+//
+// The first OAM_PRIORITY_SLOTS slots are reserved for sprites that must never
+// drop out (the player) and are written in place. Everything else is staged,
+// up to OAM_STAGE_MAX objects, and at oam_end() a window of the remaining
+// slots is copied out of the staged list, starting at an offset that rotates
+// every frame. When a scanline exceeds the PPU's 32 sprite / 34 tile limit,
+// or more objects are staged than OAM holds, a different set of sprites
+// drops each frame (flicker) instead of the same ones staying invisible.
+#define OAM_SLOTS 128
+#define OAM_PRIORITY_SLOTS 4  // Multiple of 4 (one high-table byte per 4)
+#define OAM_ROTATE_STEP 3     // Rotation advance per frame, in groups of 4
+#define OAM_STAGE_MAX 256     // Bullets, enemies and enemy bullets all fit
+
+// PPU per-scanline limits
+#define OAM_LINE_MAX_SPRITES 32
+#define OAM_LINE_MAX_TILES 34
+
+// OAM attribute byte: vhoopppN (vflip, hflip, priority, palette, name bit 8)
+#define OBJ_ATTR(pal, prio, hflip, vflip) \
+    ((u8)(((vflip) << 7) | ((hflip) << 6) | ((prio) << 4) | ((pal) << 1)))
+
+typedef struct MetaspritePiece {
+    s8 dx, dy;  // Offset from the metasprite origin
+    u8 tile;
+    u8 attr;    // OBJ_ATTR(...)
+    u8 size;    // OBJ_SMALL or OBJ_LARGE
+} MetaspritePiece;
+
+typedef struct Metasprite {
+    u8 count;
+    const MetaspritePiece* pieces;
+} Metasprite;
+
+// Visible scanlines over the sprite or tile limit in the last oam_end().
+// Only computed when built with OAM_LINE_STATS; otherwise stays 0.
+extern u8 g_oamOverLines;
+
+// Staged objects the last oam_end() had no OAM slot for (they get one in a
+// later frame as the window rotates), plus any past OAM_STAGE_MAX
+extern u16 g_oamDropped;
+
+// Hide every slot and reset the cursor (call once after sprite setup)
+void oam_init(void);
+
+// Start a new frame of sprites. Calling it again mid-frame discards what
+// was drawn so far.
+void oam_begin(void);
+
+// Append a metasprite at (x, y) to the rotating region. Pieces that are
+// fully off-screen are skipped.
+void oam_draw(const Metasprite* ms, s16 x, s16 y);
+
+// Same, into the reserved priority slots
+void oam_draw_priority(const Metasprite* ms, s16 x, s16 y);
+
+// Copy staged sprites into OAM with this frame's rotation and hide every
+// slot used last frame but not this one
+void oam_end(void);
+
+#endif
@@ -0,0 +1,108 @@
+#include <snes.h>
+
+#include "hwmath.h"
+#include "parallax.h"
+
+#ifndef REG_HDMAEN
+#define REG_HDMAEN (*(vuint8*)0x420C)
+#endif
+#ifndef REG_CGWSEL
+#define REG_CGWSEL (*(vuint8*)0x2130)
+#define REG_CGADSUB (*(vuint8*)0x2131)
+#endif
+
+// HDMA channel registers ($43x0-$43x4)
+#define HDMA_REG(ch, r) (*(vuint8*)(0x4300 + ((ch) << 4) + (r)))
+#define HDMA_DMAP 0
+#define HDMA_BBAD 1
+#define HDMA_A1TL 2
+#define HDMA_A1TH 3
+#define HDMA_A1B 4
+
+#define DMAP_1REG_1WRITE 0x00  // One byte per line entry
+#define DMAP_1REG_2WRITES 0x02  // Two bytes to the same register (scroll)
+
+#define BBAD_BG2HOFS 0x0F
+#define BBAD_COLDATA 0x32
+
+#define COLDATA_RGB 0xE0  // Set all three fixed colour channels
+
+#define CGADSUB_SUB_BG2 0x82  // Subtract the fixed colour from BG2
+
+typedef struct ParallaxBand {
+    u8 lines;  // <= 127 (one non-repeat HDMA entry)
+    u8 speed;  // Pixels per frame
+    u8 fade;   // Fixed colour intensity subtracted, 0-31
+} ParallaxBand;
+
+// Top to bottom; lines add up to 224. Slow, dim bands read as distant.
+static const ParallaxBand s_bands[PARALLAX_BANDS] = {
+    { 32, 1, 12 },
+    { 32, 2, 8 },
+    { 32, 3, 4 },
+    { 32, 4, 0 },
+    { 32, 3, 4 },
+    { 32, 2, 8 },
+    { 32, 1, 12 },
+};
+
+// Per band: line count, BG2HOFS low, BG2HOFS high; then a 0 terminator
+#define PARALLAX_ROW (PARALLAX_BANDS * 3 + 1)
+
+static u8 s_scrollTables[PARALLAX_PERIOD * PARALLAX_ROW];
+static u8 s_fadeTable[PARALLAX_BANDS * 2 + 1];
+
+static void set_source(u8 ch, const u8* table) {
+    HDMA_REG(ch, HDMA_A1TL) = (u8)(u16)table;
+    HDMA_REG(ch, HDMA_A1TH) = (u8)((u16)table >> 8);
+    HDMA_REG(ch, HDMA_A1B) = (u8)((u32)table >> 16);
+}
+
+void parallax_init(u8 fade) {
+    u8 x[PARALLAX_BANDS];
+    u8* p = s_scrollTables;
+    u16 t;
+    u8 b;
+
+    // One row per frame of the period; offsets advance by addition only
+    for (b = 0; b < PARALLAX_BANDS; b++) x[b] = 0;
+    for (t = 0; t < PARALLAX_PERIOD; t++) {
+        for (b = 0; b < PARALLAX_BANDS; b++) {
+            *p++ = s_bands[b].lines;
+            *p++ = x[b];
+            *p++ = 0;
+            x[b] += s_bands[b].speed;
+        }
+        *p++ = 0;
+    }
+
+    HDMA_REG(PARALLAX_SCROLL_CH, HDMA_DMAP) = DMAP_1REG_2WRITES;
+    HDMA_REG(PARALLAX_SCROLL_CH, HDMA_BBAD) = BBAD_BG2HOFS;
+    set_source(PARALLAX_SCROLL_CH, s_scrollTables);
+
+    if (!fade) {
+        REG_HDMAEN = 1 << PARALLAX_SCROLL_CH;
+        return;
+    }
+
+    // The fade table never changes
+    p = s_fadeTable;
+    for (b = 0; b < PARALLAX_BANDS; b++) {
+        *p++ = s_bands[b].lines;
+        *p++ = COLDATA_RGB | s_bands[b].fade;
+    }
+    *p = 0;
+
+    HDMA_REG(PARALLAX_FADE_CH, HDMA_DMAP) = DMAP_1REG_1WRITE;
+    HDMA_REG(PARALLAX_FADE_CH, HDMA_BBAD) = BBAD_COLDATA;
+    set_source(PARALLAX_FADE_CH, s_fadeTable);
+
+    REG_CGWSEL = 0x00;  // Colour math everywhere, against the fixed colour
+    REG_CGADSUB = CGADSUB_SUB_BG2;
+    REG_HDMAEN = (1 << PARALLAX_SCROLL_CH) | (1 << PARALLAX_FADE_CH);
+}
+
+void parallax_vblank(u8 phase) {
+    // HDMA reloads from A1T at the top of each frame
+    set_source(PARALLAX_SCROLL_CH, &s_scrollTables[hw_mul8(phase, PARALLAX_ROW)]);
+}
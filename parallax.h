@@ -0,0 +1,27 @@
+#ifndef STARSHMUP_PARALLAX_H
+#define STARSHMUP_PARALLAX_H
+
+#include <snes.h>
+
+// BG2 starfield parallax: horizontal screen bands scrolling at different
+// speeds, driven by HDMA.
+//
+// Every band scrolls a whole number of pixels per frame, so all offsets
+// repeat after PARALLAX_PERIOD frames. parallax_init() builds one HDMA
+// table per frame of that period; each frame, parallax_vblank() only points
+// the channel at the next table, so the CPU cost does not depend on the
+// number of bands. Optional per-band fading uses a second channel writing
+// the fixed colour ($2132), subtracted from BG2 only by colour math.
+#define PARALLAX_BANDS 7
+#define PARALLAX_PERIOD 256  // Frames; BG2's 32x32 map wraps at 256 pixels
+
+#define PARALLAX_SCROLL_CH 6  // HDMA channels, clear of general DMA
+#define PARALLAX_FADE_CH 7
+
+// Build the tables and enable HDMA (forced blank, after setMode())
+void parallax_init(u8 fade);
+
+// Select the tables for this phase of the scroll (call during VBlank)
+void parallax_vblank(u8 phase);
+
+#endif
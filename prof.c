@@ -0,0 +1,67 @@
+#include <snes.h>
+
+#include "prof.h"
+
+#ifdef PROF_ENABLE
+
+u16 g_profRing[PROF_RING_FRAMES][PROF_SECTION_COUNT];
+u8 g_profRingPos;
+ProfStats g_profStats[PROF_SECTION_COUNT];
+u16 g_profStart[PROF_SECTION_COUNT];
+
+static u16 s_sum[PROF_SECTION_COUNT];  // Sum of each g_profRing column
+static u16 s_ran;                      // Sections run this frame, one bit each (<= 16)
+static u16 s_seen;                     // Sections with a min/max sample
+
+void prof_end(u8 section) {
+    u16 line = prof_line();
+
+    // A section that crosses VBlank wraps past the last line
+    if (line < g_profStart[section]) line += PROF_FRAME_LINES;
+    g_profRing[g_profRingPos][section] += line - g_profStart[section];
+    s_ran |= 1 << section;
+}
+
+void prof_frame(void) {
+    u16* row = g_profRing[g_profRingPos];
+    ProfStats* st;
+    u16 cost;
+    u8 s;
+
+    for (s = 0; s < PROF_SECTION_COUNT; s++) {
+        st = &g_profStats[s];
+        cost = row[s];
+        s_sum[s] += cost;
+        if (s_ran & (1 << s)) {
+            if (!(s_seen & (1 << s)) || cost < st->min) st->min = cost;
+            if (cost > st->max) st->max = cost;
+        }
+    }
+    s_seen |= s_ran;
+    s_ran = 0;
+
+    // Retire the oldest row; it becomes the next frame's row
+    g_profRingPos = (g_profRingPos + 1) & (PROF_RING_FRAMES - 1);
+    row = g_profRing[g_profRingPos];
+    for (s = 0; s < PROF_SECTION_COUNT; s++) {
+        s_sum[s] -= row[s];
+        row[s] = 0;
+        g_profStats[s].avg = s_sum[s] >> PROF_RING_SHIFT;
+    }
+}
+
+#endif
+
+u16 prof_line(void) {
+    u16 h, v;
+
+    (void)REG_STAT78;  // Reset the OPHCT/OPVCT read flip-flops
+    (void)REG_SLHV;    // Latch both counters
+    h = REG_OPHCT;     // Each counter is read low byte, then bit 8
+    h |= (u16)(REG_OPHCT & 1) << 8;
+    v = REG_OPVCT;
+    v |= (u16)(REG_OPVCT & 1) << 8;
+
+    // 340 dots per line: past the middle counts as the next line
+    return (h >= 170) ? v + 1 : v;
+}
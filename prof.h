@@ -0,0 +1,103 @@
+#ifndef STARSHMUP_PROF_H
+#define STARSHMUP_PROF_H
+
+#include <snes.h>
+
+// Per-system timing sections. In the ROM they compile to nothing unless
+// PROF_ENABLE is set (`./build.sh debug`), in which case each section
+// latches the PPU H/V counters at its start and end and adds the scanlines
+// spent to this frame's row of g_profRing. The host build (host/) times the
+// same sections with the OS clock.
+enum {
+    PROF_PLAYER,     // Movement, clamping and autofire
+    PROF_ENEMIES,    // Per-type updates and grid relinking
+    PROF_BULLETS,    // Fused move / cull / collide / draw pass
+    PROF_WAVES,      // Wave script
+    PROF_EBULLETS,   // Enemy bullet volleys, half-pool move and player test
+    PROF_COLLIDE,    // Player vs enemy
+    PROF_OAM,        // Enemy / enemy bullet draw and OAM rotation
+    PROF_GAME_STEP,  // All of game_step() (includes the sections above)
+    PROF_SFX,        // sfx_process() / spcProcess()
+    PROF_JOBS,       // jobs_run()
+    PROF_OAM_DMA,    // oamUpdate()
+    PROF_XFER,       // xfer_vblank()
+    PROF_SECTION_COUNT
+};
+
+#define PROF_RING_SHIFT 6
+#define PROF_RING_FRAMES (1 << PROF_RING_SHIFT)
+#define PROF_FRAME_LINES 262  // NTSC scanlines per frame, for V counter wrap
+
+// INIDISP values for the CPU meter: screen dims while the CPU is busy, so
+// the dark band from the top of the screen is the frame time used
+#define PROF_METER_BUSY 0x07
+#define PROF_METER_IDLE 0x0F
+
+#if defined(HOST_BUILD)
+
+void host_prof_begin(u8 section);
+void host_prof_end(u8 section);
+#define PROF_BEGIN(s) host_prof_begin(s)
+#define PROF_END(s) host_prof_end(s)
+#define PROF_FRAME()
+#define PROF_METER(v)
+
+#elif defined(PROF_ENABLE)
+
+#ifndef REG_INIDISP
+#define REG_INIDISP (*(vuint8*)0x2100)
+#endif
+
+// Scanline costs for a section: avg over the last PROF_RING_FRAMES frames
+// (frames where it did not run count as 0), min/max since boot over the
+// frames where it ran.
+typedef struct ProfStats {
+    u16 min;
+    u16 avg;
+    u16 max;
+} ProfStats;
+
+// Per-frame scanline cost of each section; row g_profRingPos is the
+// frame being measured. Both tables are plain WRAM globals, found through
+// starshmup.sym for an emulator's memory viewer.
+extern u16 g_profRing[PROF_RING_FRAMES][PROF_SECTION_COUNT];
+extern u8 g_profRingPos;
+extern ProfStats g_profStats[PROF_SECTION_COUNT];
+
+extern u16 g_profStart[PROF_SECTION_COUNT];
+
+void prof_end(u8 section);
+
+// Close this frame's row and update g_profStats; call once per frame
+void prof_frame(void);
+
+#define PROF_BEGIN(s) (g_profStart[s] = prof_line())
+#define PROF_END(s) prof_end(s)
+#define PROF_FRAME() prof_frame()
+#define PROF_METER(v) (REG_INIDISP = (v))
+
+#else
+
+#define PROF_BEGIN(s)
+#define PROF_END(s)
+#define PROF_FRAME()
+#define PROF_METER(v)
+
+#endif
+
+#ifndef HOST_BUILD
+
+#ifndef REG_SLHV
+#define REG_SLHV (*(vuint8*)0x2137)
+#define REG_OPHCT (*(vuint8*)0x213C)
+#define REG_OPVCT (*(vuint8*)0x213D)
+#define REG_STAT78 (*(vuint8*)0x213F)
+#endif
+
+// Current scanline, rounded to the nearest line by the H counter. Always
+// built: the job scheduler (jobs.h) uses it for its deadline.
+u16 prof_line(void);
+
+#endif
+
+#endif
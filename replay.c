@@ -0,0 +1,121 @@
+#include <snes.h>
+
+#include "game.h"
+#include "jobs.h"
+#include "replay.h"
+#include "rng.h"
+
+ReplayState g_replay;
+
+// The SRAM image; runs are appended in place
+static u8 s_image[REPLAY_BYTES];
+
+// Current run: its byte offset in s_image. Playback also tracks the
+// frames left in it and the runs left after it.
+static u16 s_run;
+static u8 s_left;
+static u16 s_runsLeft;
+
+static u16 s_hashLeft;   // Frames until the next logged hash
+static u8 s_hashedLast;  // Logged the hash at the end of the recording
+
+static void put_u16(u16 at, u16 v) {
+    s_image[at] = (u8)v;
+    s_image[at + 1] = (u8)(v >> 8);
+}
+
+static u16 get_u16(u16 at) {
+    return s_image[at] | ((u16)s_image[at + 1] << 8);
+}
+
+void replay_record_start(void) {
+    s_image[0] = 'R';
+    s_image[1] = 'P';
+    s_image[2] = 'L';
+    s_image[3] = 'Y';
+    put_u16(4, g_rng);
+    g_replay.runs = 0;
+    g_replay.full = 0;
+    s_run = REPLAY_HEADER;
+}
+
+// Extend the current run if the pad is unchanged and its count has room,
+// else start a new one
+void replay_record(u16 pad) {
+    if (g_replay.full) return;
+
+    if (g_replay.runs && get_u16(s_run) == pad && s_image[s_run + 2] != 0xFF) {
+        s_image[s_run + 2]++;
+        return;
+    }
+    if (g_replay.runs == REPLAY_MAX_RUNS) {
+        g_replay.full = 1;
+        return;
+    }
+    if (g_replay.runs) s_run += REPLAY_RUN;
+    put_u16(s_run, pad);
+    s_image[s_run + 2] = 1;
+    g_replay.runs++;
+}
+
+// One step: consoleCopySram() always starts at the beginning of SRAM, so
+// the header and the runs so far go in a single copy
+static u8 save_job(u16 step) {
+    (void)step;
+    put_u16(6, g_replay.runs);
+    consoleCopySram(s_image, REPLAY_HEADER + g_replay.runs * REPLAY_RUN);
+    return JOB_DONE;
+}
+
+void replay_save(void) {
+    jobs_add(save_job, JOB_PRIO_LOW);
+}
+
+void replay_load(void) {
+    consoleLoadSram(s_image, REPLAY_BYTES);
+    g_replay.loaded = s_image[0] == 'R' && s_image[1] == 'P' &&
+                      s_image[2] == 'L' && s_image[3] == 'Y' &&
+                      get_u16(6) <= REPLAY_MAX_RUNS;
+    if (!g_replay.loaded) {
+        g_replay.done = 1;
+        return;
+    }
+
+    g_rng = get_u16(4);
+    g_replay.runs = get_u16(6);
+    g_replay.done = g_replay.runs == 0;
+    s_runsLeft = g_replay.runs;
+    s_run = REPLAY_HEADER;
+    s_left = s_image[s_run + 2];
+    s_hashLeft = REPLAY_HASH_FRAMES;
+}
+
+// Pads after the end of the recording are released
+u16 replay_pad(void) {
+    u16 pad;
+
+    if (g_replay.done) return 0;
+
+    pad = get_u16(s_run);
+    if (--s_left == 0) {
+        if (--s_runsLeft == 0) {
+            g_replay.done = 1;
+        } else {
+            s_run += REPLAY_RUN;
+            s_left = s_image[s_run + 2];
+        }
+    }
+    return pad;
+}
+
+// The frame that ends the recording always logs a hash. Once the log is
+// full, the last entry keeps being replaced.
+void replay_frame_end(void) {
+    if (!g_replay.loaded || s_hashedLast) return;
+    if (--s_hashLeft && !g_replay.done) return;
+
+    if (g_replay.hash_count == REPLAY_HASHES) g_replay.hash_count--;
+    g_replay.hashes[g_replay.hash_count++] = game_hash();
+    s_hashLeft = REPLAY_HASH_FRAMES;
+    s_hashedLast = g_replay.done;
+}
@@ -0,0 +1,52 @@
+#ifndef STARSHMUP_REPLAY_H
+#define STARSHMUP_REPLAY_H
+
+#include <snes.h>
+
+// Input recording and replay. Gameplay depends only on the pad stream and
+// the g_rng seed, so a recording of both replays a session exactly.
+//
+// Normal builds record every frame's pad into a WRAM buffer as runs and
+// copy it to battery SRAM after each game over. `make REPLAY=1` builds a
+// ROM that loads the recording from SRAM at boot, feeds it back instead of
+// the pad and logs game_hash() every REPLAY_HASH_FRAMES frames. The host
+// build replays the same data from an SRAM dump (host/starshmup_host -r).
+//
+// Image, identical in WRAM, SRAM and SRAM dumps (little-endian):
+//   0  "RPLY"
+//   4  u16 g_rng at the first recorded frame
+//   6  u16 run count
+//   8  runs: u16 pad, u8 frames (1-255)
+#define REPLAY_BYTES 8192  // SRAMSIZE $03 in hdr.asm
+#define REPLAY_HEADER 8
+#define REPLAY_RUN 3
+#define REPLAY_MAX_RUNS ((REPLAY_BYTES - REPLAY_HEADER) / REPLAY_RUN)
+
+#define REPLAY_HASH_FRAMES 600  // 10 seconds at 60 Hz
+#define REPLAY_HASHES 64
+
+typedef struct ReplayState {
+    u16 runs;      // Runs recorded, or in the loaded recording
+    u8 full;       // Recording stopped: out of runs
+    u8 loaded;     // REPLAY: a valid recording was found in SRAM
+    u8 done;       // REPLAY: every run has been fed back
+    u16 hash_count;
+    u16 hashes[REPLAY_HASHES];  // REPLAY: game_hash() every REPLAY_HASH_FRAMES
+} ReplayState;
+
+extern ReplayState g_replay;
+
+// Recording: start at boot, then pass every frame's pad
+void replay_record_start(void);
+void replay_record(u16 pad);
+
+// Queue a job copying the recording so far to SRAM
+void replay_save(void);
+
+// Replay: load from SRAM and restore the seed, then take each frame's pad
+// from replay_pad() and call replay_frame_end() after game_step()
+void replay_load(void);
+u16 replay_pad(void);
+void replay_frame_end(void);
+
+#endif
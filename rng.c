@@ -0,0 +1,14 @@
+#include <snes.h>
+
+#include "rng.h"
+
+u16 g_rng = 0xACE1u;
+
+u16 rng_next_u16(void) {
+    u16 lsb = g_rng & 1u;
+    g_rng >>= 1;
+    if (lsb) {
+        g_rng ^= 0xB400u;
+    }
+    return g_rng;
+}
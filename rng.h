@@ -0,0 +1,11 @@
+#ifndef STARSHMUP_RNG_H
+#define STARSHMUP_RNG_H
+
+#include <snes.h>
+
+// Galois LFSR (16-bit) random number generator
+extern u16 g_rng;
+
+u16 rng_next_u16(void);
+
+#endif
@@ -1,4 +1,6 @@
 #include <snes.h>
+#include "hud.h"
+#include "jobs.h"
 #include "scenes.h"
 
 #define GAMEOVER_ROW 6
@@ -9,55 +11,40 @@
 // Local copy of stats for display
 static GameStats s_stats;
 
-// Format u16 as decimal string. Buffer must hold at least 6 chars.
-static void format_number(u16 v, char* out) {
-    char tmp[6];
-    u8 n = 0;
-    u8 i;
-
-    if (v == 0) {
-        out[0] = '0';
-        out[1] = '\0';
-        return;
-    }
-
-    while (v > 0) {
-        tmp[n++] = '0' + (v % 10);
-        v /= 10;
-    }
-
-    for (i = 0; i < n; i++) {
-        out[i] = tmp[n - 1 - i];
+// Clears the game over text one row per step, in spare time after START
+static u8 clear_gameover_job(u16 step) {
+    switch (step) {
+        case 0: hud_text(11, GAMEOVER_ROW, "         "); break;
+        case 1: hud_text(10, LEVEL_ROW, "            "); break;
+        case 2: hud_text(10, KILLS_ROW, "            "); break;
+        default: hud_text(10, PROMPT_ROW, "           "); return JOB_DONE;
     }
-    out[n] = '\0';
+    return JOB_MORE;
 }
 
 void scene_gameover_enter(const GameStats* stats) {
-    char buf[12];
+    char buf[BCD_DIGITS + 1];
 
     s_stats = *stats;
+    jobs_finish(clear_gameover_job);  // From the last game over, if still queued
 
     // Display game over screen
-    consoleDrawText(11, GAMEOVER_ROW, "GAME OVER");
+    hud_text(11, GAMEOVER_ROW, "GAME OVER");
 
-    consoleDrawText(10, LEVEL_ROW, "LEVEL: ");
-    format_number(s_stats.level, buf);
-    consoleDrawText(17, LEVEL_ROW, buf);
+    hud_text(10, LEVEL_ROW, "LEVEL: ");
+    bcd_to_str(&s_stats.level, buf);
+    hud_text(17, LEVEL_ROW, buf);
 
-    consoleDrawText(10, KILLS_ROW, "KILLS: ");
-    format_number(s_stats.kills, buf);
-    consoleDrawText(17, KILLS_ROW, buf);
+    hud_text(10, KILLS_ROW, "KILLS: ");
+    bcd_to_str(&s_stats.kills, buf);
+    hud_text(17, KILLS_ROW, buf);
 
-    consoleDrawText(10, PROMPT_ROW, "PRESS START");
+    hud_text(10, PROMPT_ROW, "PRESS START");
 }
 
 Scene scene_gameover_update(u16 pad) {
     if (pad & KEY_START) {
-        // Clear game over text before transitioning
-        consoleDrawText(11, GAMEOVER_ROW, "         ");
-        consoleDrawText(10, LEVEL_ROW, "            ");
-        consoleDrawText(10, KILLS_ROW, "            ");
-        consoleDrawText(10, PROMPT_ROW, "           ");
+        jobs_add(clear_gameover_job, JOB_PRIO_NORMAL);
         return SCENE_TITLE;
     }
     return SCENE_GAMEOVER;
@@ -1,4 +1,6 @@
 #include <snes.h>
+#include "hud.h"
+#include "jobs.h"
 #include "scenes.h"
 
 #define TITLE_ROW 8
@@ -6,19 +8,27 @@
 
 #define COPYRIGHT_ROW 20
 
+// Clears the title text one row per step, in spare time after START
+static u8 clear_title_job(u16 step) {
+    switch (step) {
+        case 0: hud_text(11, TITLE_ROW, "         "); break;
+        case 1: hud_text(10, PROMPT_ROW, "           "); break;
+        default: hud_text(6, COPYRIGHT_ROW, "                   "); return JOB_DONE;
+    }
+    return JOB_MORE;
+}
+
 void scene_title_enter(void) {
     // Clear any previous text and display title
-    consoleDrawText(11, TITLE_ROW, "STARSHMUP");
-    consoleDrawText(10, PROMPT_ROW, "PRESS START");
-    consoleDrawText(6, COPYRIGHT_ROW, "(C) 2026 JACK GAMES");
+    jobs_finish(clear_title_job);
+    hud_text(11, TITLE_ROW, "STARSHMUP");
+    hud_text(10, PROMPT_ROW, "PRESS START");
+    hud_text(6, COPYRIGHT_ROW, "(C) 2026 JACK GAMES");
 }
 
 Scene scene_title_update(u16 pad) {
     if (pad & KEY_START) {
-        // Clear title text before transitioning
-        consoleDrawText(11, TITLE_ROW, "         ");
-        consoleDrawText(10, PROMPT_ROW, "           ");
-        consoleDrawText(6, COPYRIGHT_ROW, "                   ");
+        jobs_add(clear_title_job, JOB_PRIO_NORMAL);
         return SCENE_GAMEPLAY;
     }
     return SCENE_TITLE;
@@ -2,17 +2,20 @@
 
 #include <snes.h>
 
+#include "bcd.h"
+
 // Game scenes
 typedef enum {
     SCENE_TITLE,
     SCENE_GAMEPLAY,
     SCENE_GAMEOVER
 } Scene;
+#define SCENE_COUNT 3
 
 // Shared game state (accessible across scenes)
 typedef struct {
-    u16 kills;
-    u16 level;
+    Bcd kills;
+    Bcd level;
 } GameStats;
 
 // Scene functions
@@ -1,90 +1,150 @@
 #include <snes.h>
 
+#include "jobs.h"
 #include "sfx.h"
 
 extern char SOUNDBANK__;
 extern char sfx_laser, sfx_laser_end;
 extern char sfx_explosion, sfx_explosion_end;
 
-static brrsamples g_sfxLaser;
-static brrsamples g_sfxExplosion;
+typedef struct SfxSample {
+    char* start;
+    char* end;
+    u8 pitch;
+} SfxSample;
 
-static u8 g_sfxLockFrames = 0;
-static u8 g_laserCooldownFrames = 0;
-
-enum {
-    // spcPlaySound() index 0 is the last sound registered via spcSetSoundEntry().
-    SFX_IDX_LASER = 0,
-    SFX_IDX_EXPLOSION = 1,
+// Indexed by SFX_SAMPLE_*
+static const SfxSample s_samples[SFX_SAMPLE_COUNT] = {
+    { &sfx_laser, &sfx_laser_end, 4 },
+    { &sfx_explosion, &sfx_explosion_end, 3 },
 };
 
-void sfx_init(void) {
-    u16 explosion_len;
-    u16 laser_len;
+static brrsamples g_sfxBrr[SFX_SAMPLE_COUNT];
+
+u8 g_sfxReady;
 
-    // Initialize sound engine (takes some time).
-    spcBoot();
+static u8 s_wanted;  // Samples asked for by sfx_load_set()
 
-    // Provide a soundbank origin (even if we only use BRR SFX).
-    spcSetBank((u8 *)&SOUNDBANK__);
+// spcPlaySound() index 0 is the last sound registered via spcSetSoundEntry(),
+// so a sample's index depends on how many were loaded after it
+static u8 s_loadOrder[SFX_SAMPLE_COUNT];
+static u8 s_loadedCount;
 
-    // Reserve SPC RAM for BRR SFX (size * 256 bytes). Must fit our largest sample.
-    spcAllocateSoundRegion(40);
+typedef struct SfxDef {
+    u8 sample;  // SFX_SAMPLE_*
+    u8 volume;
+    u8 frames;  // How long the effect holds its voice
+} SfxDef;
+
+// Indexed by SFX_*; priority is the index
+static const SfxDef s_sfxDefs[SFX_COUNT] = {
+    { SFX_SAMPLE_LASER, 15, 8 },       // SFX_SHOT
+    { SFX_SAMPLE_LASER, 12, 10 },      // SFX_ENEMY_HIT
+    { SFX_SAMPLE_LASER, 15, 10 },      // SFX_UI_CONFIRM
+    { SFX_SAMPLE_EXPLOSION, 15, 24 },  // SFX_ENEMY_DOWN
+    { SFX_SAMPLE_EXPLOSION, 12, 28 },  // SFX_LEVEL_UP
+    { SFX_SAMPLE_EXPLOSION, 15, 60 },  // SFX_PLAYER_DOWN
+};
 
-    explosion_len = (u16)(&sfx_explosion_end - &sfx_explosion);
-    laser_len = (u16)(&sfx_laser_end - &sfx_laser);
+// Requests since the last sfx_process(), one bit per SFX_*
+static u8 s_pending;
 
-    // Register EXPLOSION first so LASER becomes index 0 (most frequently played).
-    spcSetSoundEntry(15, 8, 3, explosion_len, (u8 *)&sfx_explosion, &g_sfxExplosion);
-    spcSetSoundEntry(15, 8, 4, laser_len, (u8 *)&sfx_laser, &g_sfxLaser);
+// What each voice is playing (SFX_*) and for how many more frames
+static u8 s_voiceSfx[SFX_VOICES];
+static u8 s_voiceFrames[SFX_VOICES];
+
+static u8 sfx_load_job(u16 step) {
+    (void)step;
+    return sfx_load_step() ? JOB_MORE : JOB_DONE;
 }
 
-void sfx_process(void) {
-    if (g_sfxLockFrames) {
-        g_sfxLockFrames--;
+void sfx_load_set(u8 samples) {
+    s_wanted |= samples;
+    if (s_wanted & (u8)~g_sfxReady) jobs_add(sfx_load_job, JOB_PRIO_LOW);
+}
+
+// spcBoot() and spcSetSoundEntry() each block until their transfer is done
+// and cannot be split further, so a step is one of those calls. They used
+// to run back to back before the first frame; now each is one job step,
+// run while the title is already up.
+u8 sfx_load_step(void) {
+    u8 i, missing;
+
+    if (!(g_sfxReady & SFX_READY_DRIVER)) {
+        spcBoot();
+
+        // Provide a soundbank origin (even if we only use BRR SFX).
+        spcSetBank((u8 *)&SOUNDBANK__);
+
+        // Reserve SPC RAM for BRR SFX (size * 256 bytes). Must fit all samples.
+        spcAllocateSoundRegion(40);
+
+        g_sfxReady = SFX_READY_DRIVER;
+        return 1;
     }
-    if (g_laserCooldownFrames) {
-        g_laserCooldownFrames--;
+
+    missing = s_wanted & (u8)~g_sfxReady;
+    if (!missing) return 0;
+
+    for (i = 0; !(missing & (1 << i)); i++) {
     }
-    spcProcess();
-}
+    spcSetSoundEntry(15, 8, s_samples[i].pitch,
+                     (u16)(s_samples[i].end - s_samples[i].start),
+                     (u8 *)s_samples[i].start, &g_sfxBrr[i]);
+    s_loadOrder[i] = s_loadedCount++;
+    g_sfxReady |= (u8)(1 << i);
 
-static u8 sfx_can_play_laser(void) {
-    return (g_sfxLockFrames == 0) && (g_laserCooldownFrames == 0);
+    return (missing & (u8)~(1 << i)) != 0;
 }
 
-void sfx_ui_confirm(void) {
-    if (!sfx_can_play_laser()) return;
-    g_laserCooldownFrames = 10;
-    spcPlaySoundV(SFX_IDX_LASER, 15);
+// Any number of calls per frame cost the same: repeats just set the bit again
+void sfx_request(u8 sfx) {
+    if (!(g_sfxReady & (1 << s_sfxDefs[sfx].sample))) return;
+    s_pending |= (u8)(1 << sfx);
 }
 
-void sfx_shot(void) {
-    if (!sfx_can_play_laser()) return;
-    g_laserCooldownFrames = 8;
-    spcPlaySoundV(SFX_IDX_LASER, 15);
+// Voice for a new effect: a free one, else the lowest-priority one playing
+// something below it. SFX_VOICES if every voice is busy with something at
+// least as important.
+static u8 pick_voice(u8 sfx) {
+    u8 v, best = SFX_VOICES;
+    u8 best_prio = sfx;
+
+    for (v = 0; v < SFX_VOICES; v++) {
+        if (s_voiceFrames[v] == 0) return v;
+        if (s_voiceSfx[v] < best_prio) {
+            best_prio = s_voiceSfx[v];
+            best = v;
+        }
+    }
+    return best;
 }
 
-void sfx_enemy_hit(void) {
-    if (!sfx_can_play_laser()) return;
-    g_laserCooldownFrames = 10;
-    spcPlaySoundV(SFX_IDX_LASER, 12);
-}
+// Once per frame: age the voices, start the merged requests from the
+// highest priority down (at most one SPC handshake per voice), then run
+// the driver
+void sfx_process(void) {
+    u8 v, sfx, sample;
 
-void sfx_enemy_down(void) {
-    g_sfxLockFrames = 24;
-    g_laserCooldownFrames = 24;
-    spcPlaySoundV(SFX_IDX_EXPLOSION, 15);
-}
+    if (!(g_sfxReady & SFX_READY_DRIVER)) return;
 
-void sfx_level_up(void) {
-    g_sfxLockFrames = 28;
-    g_laserCooldownFrames = 28;
-    spcPlaySoundV(SFX_IDX_EXPLOSION, 12);
-}
+    for (v = 0; v < SFX_VOICES; v++) {
+        if (s_voiceFrames[v]) s_voiceFrames[v]--;
+    }
 
-void sfx_player_down(void) {
-    g_sfxLockFrames = 60;
-    g_laserCooldownFrames = 60;
-    spcPlaySoundV(SFX_IDX_EXPLOSION, 15);
+    sfx = SFX_COUNT;
+    while (s_pending && sfx--) {
+        if (!(s_pending & (1 << sfx))) continue;
+        s_pending &= (u8)~(1 << sfx);
+
+        v = pick_voice(sfx);
+        if (v == SFX_VOICES) continue;  // Dropped: outranked everywhere
+        s_voiceSfx[v] = sfx;
+        s_voiceFrames[v] = s_sfxDefs[sfx].frames;
+        sample = s_sfxDefs[sfx].sample;
+        spcPlaySoundV(s_loadedCount - 1 - s_loadOrder[sample], s_sfxDefs[sfx].volume);
+    }
+    s_pending = 0;
+
+    spcProcess();
 }
@@ -1,15 +1,50 @@
 #ifndef STARSHMUP_SFX_H
 #define STARSHMUP_SFX_H
 
-void sfx_init(void);
-void sfx_process(void);
+#include <snes.h>
 
-void sfx_ui_confirm(void);
-void sfx_shot(void);
-void sfx_enemy_hit(void);
-void sfx_enemy_down(void);
-void sfx_level_up(void);
-void sfx_player_down(void);
+// Sound effects, lowest priority first. Requests made during a frame are
+// merged (one per effect) and submitted together by sfx_process().
+enum {
+    SFX_SHOT,
+    SFX_ENEMY_HIT,
+    SFX_UI_CONFIRM,
+    SFX_ENEMY_DOWN,
+    SFX_LEVEL_UP,
+    SFX_PLAYER_DOWN,
+    SFX_COUNT
+};
 
-#endif
+// Effect voices tracked by the voice manager
+#define SFX_VOICES 2
+
+// BRR samples, uploaded to SPC RAM on demand
+enum {
+    SFX_SAMPLE_LASER,
+    SFX_SAMPLE_EXPLOSION,
+    SFX_SAMPLE_COUNT
+};
+
+// Sample sets per scene, masks of 1 << SFX_SAMPLE_*
+#define SFX_SET_TITLE (1 << SFX_SAMPLE_LASER)
+#define SFX_SET_GAME  ((1 << SFX_SAMPLE_LASER) | (1 << SFX_SAMPLE_EXPLOSION))
+
+// Sound is brought up after the first frame is on screen by a low-priority
+// job (jobs.h): the driver boot, then one sample per step. Bits of g_sfxReady are
+// the loaded samples, plus SFX_READY_DRIVER once the driver runs; requests
+// for effects whose sample is not there yet are ignored.
+#define SFX_READY_DRIVER 0x80
+
+extern u8 g_sfxReady;
 
+// Ask for a sample set, queueing the load job if anything is missing;
+// samples already loaded stay loaded
+void sfx_load_set(u8 samples);
+
+// Do one loading step now; returns nonzero while work is left
+u8 sfx_load_step(void);
+
+void sfx_request(u8 sfx);
+void sfx_process(void);
+
+#endif
@@ -0,0 +1,420 @@
+// PNG to SNES tile converter.
+//
+//   gfxconv [-b 2|4] [-d] [-l] [-k masks.inc] [-m map.out] [-p pal.out]
+//           [-t first_tile] [-P palette] in.png tiles.out
+//
+// Cuts the image into 8x8 tiles, left to right and top to bottom, and
+// writes them in SNES planar format (2bpp: 16 bytes/tile, 4bpp: 32).
+//
+//   -b  Bits per pixel (default 4)
+//   -d  Drop tiles identical to an earlier one, also when flipped
+//       horizontally and/or vertically; the tilemap records the flips
+//   -k  Write 1-bit collision masks as a C initializer list: for each
+//       16-pixel column of the image, one u16 per pixel row (bit 15 =
+//       leftmost pixel, set where the index is not 0)
+//   -l  LZ-compress the tiles and tilemap for lz_to_vram() (see lz.h)
+//   -m  Write a tilemap (u16 per 8x8 cell: tile | palette << 10 | flips)
+//   -p  Write the palette (BGR555, 2^bpp entries)
+//   -t  Tile number of the first tile, for tilemap entries
+//   -P  Palette number for tilemap entries
+//
+// Indexed PNGs use their pixel indices directly. Truecolour PNGs get
+// indices in order of first appearance, with fully transparent pixels as
+// index 0. Needs zlib (-lz).
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#define LZ_WINDOW 256
+#define LZ_MIN_MATCH 3
+#define LZ_MAX_MATCH (255 + LZ_MIN_MATCH)
+
+#define MAP_HFLIP 0x4000
+#define MAP_VFLIP 0x8000
+
+typedef struct Image {
+    uint32_t w, h;
+    uint8_t* idx;         // One palette index per pixel
+    uint16_t pal[256];    // BGR555
+    uint32_t pal_count;
+} Image;
+
+typedef struct Buf {
+    uint8_t* data;
+    size_t len, cap;
+} Buf;
+
+static void die(const char* msg, const char* arg) {
+    fprintf(stderr, "gfxconv: %s%s%s\n", msg, arg ? ": " : "", arg ? arg : "");
+    exit(1);
+}
+
+static void buf_put(Buf* b, uint8_t v) {
+    if (b->len == b->cap) {
+        b->cap = b->cap ? b->cap * 2 : 1024;
+        b->data = realloc(b->data, b->cap);
+        if (!b->data) die("out of memory", NULL);
+    }
+    b->data[b->len++] = v;
+}
+
+static uint32_t be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint16_t bgr555(uint8_t r, uint8_t g, uint8_t b) {
+    return (uint16_t)((r >> 3) | ((g >> 3) << 5) | ((b >> 3) << 10));
+}
+
+static uint8_t* read_file(const char* path, size_t* len) {
+    FILE* f = fopen(path, "rb");
+    uint8_t* data;
+    long n;
+
+    if (!f) die("cannot open", path);
+    fseek(f, 0, SEEK_END);
+    n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    data = malloc(n > 0 ? (size_t)n : 1);
+    if (!data || fread(data, 1, (size_t)n, f) != (size_t)n) die("cannot read", path);
+    fclose(f);
+    *len = (size_t)n;
+    return data;
+}
+
+static void write_file(const char* path, const uint8_t* data, size_t len) {
+    FILE* f = fopen(path, "wb");
+
+    if (!f || fwrite(data, 1, len, f) != len) die("cannot write", path);
+    fclose(f);
+}
+
+static uint8_t paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+
+    if (pa <= pb && pa <= pc) return a;
+    return (pb <= pc) ? b : c;
+}
+
+// Undo the per-row PNG filters in place; bpp is bytes per complete pixel
+static void unfilter(uint8_t* raw, uint32_t rows, size_t stride, size_t bpp) {
+    uint8_t* prev = NULL;
+    uint32_t y;
+    size_t x;
+
+    for (y = 0; y < rows; y++) {
+        uint8_t* row = raw + y * (stride + 1);
+        uint8_t type = row[0];
+        uint8_t* p = row + 1;
+
+        for (x = 0; x < stride; x++) {
+            uint8_t a = (x >= bpp) ? p[x - bpp] : 0;
+            uint8_t b = prev ? prev[x] : 0;
+            uint8_t c = (prev && x >= bpp) ? prev[x - bpp] : 0;
+
+            switch (type) {
+                case 0: break;
+                case 1: p[x] += a; break;
+                case 2: p[x] += b; break;
+                case 3: p[x] += (uint8_t)((a + b) >> 1); break;
+                case 4: p[x] += paeth(a, b, c); break;
+                default: die("bad PNG filter", NULL);
+            }
+        }
+        prev = p;
+    }
+}
+
+static uint8_t color_index(Image* img, uint16_t c) {
+    uint32_t i;
+
+    for (i = 1; i < img->pal_count; i++) {
+        if (img->pal[i] == c) return (uint8_t)i;
+    }
+    if (img->pal_count == 256) die("more than 256 colours", NULL);
+    img->pal[img->pal_count] = c;
+    return (uint8_t)img->pal_count++;
+}
+
+static void load_png(const char* path, Image* img) {
+    static const uint8_t sig[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    size_t len, pos = 8, stride, bpp;
+    uint8_t* file = read_file(path, &len);
+    uint8_t depth = 0, ctype = 0;
+    uint8_t* raw;
+    uLongf raw_len;
+    Buf idat = { 0 };
+    uint32_t x, y, i;
+
+    if (len < 8 || memcmp(file, sig, 8) != 0) die("not a PNG", path);
+    memset(img, 0, sizeof(*img));
+
+    while (pos + 12 <= len) {
+        uint32_t n = be32(file + pos);
+        const uint8_t* type = file + pos + 4;
+        const uint8_t* data = file + pos + 8;
+
+        if (pos + 12 + n > len) die("truncated PNG", path);
+        if (memcmp(type, "IHDR", 4) == 0) {
+            img->w = be32(data);
+            img->h = be32(data + 4);
+            depth = data[8];
+            ctype = data[9];
+            if (data[12]) die("interlaced PNGs are not supported", path);
+        } else if (memcmp(type, "PLTE", 4) == 0) {
+            for (i = 0; i < n / 3 && i < 256; i++) {
+                img->pal[i] = bgr555(data[i * 3], data[i * 3 + 1], data[i * 3 + 2]);
+            }
+            img->pal_count = i;
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            for (i = 0; i < n; i++) buf_put(&idat, data[i]);
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + n;
+    }
+
+    if (ctype == 3 && depth <= 8) {
+        bpp = 1;
+        stride = ((size_t)img->w * depth + 7) / 8;
+    } else if ((ctype == 2 || ctype == 6) && depth == 8) {
+        bpp = (ctype == 6) ? 4 : 3;
+        stride = (size_t)img->w * bpp;
+    } else {
+        die("only indexed or 8-bit RGB/RGBA PNGs are supported", path);
+    }
+    if (img->w % 8 || img->h % 8) die("image size must be a multiple of 8", path);
+
+    raw_len = (uLongf)((stride + 1) * img->h);
+    raw = malloc(raw_len);
+    if (!raw || uncompress(raw, &raw_len, idat.data, (uLong)idat.len) != Z_OK ||
+        raw_len != (stride + 1) * img->h) {
+        die("bad PNG image data", path);
+    }
+    unfilter(raw, img->h, stride, bpp);
+
+    img->idx = malloc((size_t)img->w * img->h);
+    if (ctype != 3) img->pal_count = 1;  // Index 0 is transparent
+    for (y = 0; y < img->h; y++) {
+        const uint8_t* p = raw + y * (stride + 1) + 1;
+
+        for (x = 0; x < img->w; x++) {
+            uint8_t v;
+
+            if (ctype == 3) {
+                uint32_t bit = x * depth;
+                v = (uint8_t)((p[bit >> 3] >> (8 - depth - (bit & 7))) & ((1 << depth) - 1));
+            } else if (ctype == 6 && p[x * 4 + 3] == 0) {
+                v = 0;
+            } else {
+                v = color_index(img, bgr555(p[x * bpp], p[x * bpp + 1], p[x * bpp + 2]));
+            }
+            img->idx[y * img->w + x] = v;
+        }
+    }
+
+    free(raw);
+    free(idat.data);
+    free(file);
+}
+
+// Fetch an 8x8 tile as 64 indices, optionally flipped
+static void get_tile(const Image* img, uint32_t tx, uint32_t ty, int hflip, int vflip,
+                     uint8_t out[64]) {
+    int x, y;
+
+    for (y = 0; y < 8; y++) {
+        for (x = 0; x < 8; x++) {
+            int sx = hflip ? 7 - x : x;
+            int sy = vflip ? 7 - y : y;
+            out[y * 8 + x] = img->idx[(ty * 8 + sy) * img->w + tx * 8 + sx];
+        }
+    }
+}
+
+// SNES planar tile: bitplane pairs interleaved per row, 2bpp blocks of 16 bytes
+static void put_tile(Buf* out, const uint8_t px[64], int bits) {
+    int pair, y, x, plane;
+
+    for (pair = 0; pair < bits; pair += 2) {
+        for (y = 0; y < 8; y++) {
+            for (plane = pair; plane < pair + 2; plane++) {
+                uint8_t v = 0;
+                for (x = 0; x < 8; x++) {
+                    v |= (uint8_t)(((px[y * 8 + x] >> plane) & 1) << (7 - x));
+                }
+                buf_put(out, v);
+            }
+        }
+    }
+}
+
+// LZSS: u16 output size, then groups of 8 tokens behind a flag byte (bit 0
+// first). Flag 0: literal byte. Flag 1: distance - 1, length - 3; the
+// distance reaches at most LZ_WINDOW bytes back, matching the decoder's ring.
+static void lz_compress(const Buf* in, Buf* out) {
+    size_t pos = 0, flag_at = 0;
+    int bit = 8;
+
+    if (in->len > 0xFFFF) die("blob larger than 64 KB", NULL);
+    buf_put(out, (uint8_t)in->len);
+    buf_put(out, (uint8_t)(in->len >> 8));
+
+    while (pos < in->len) {
+        size_t best_len = 0, best_dist = 0, dist;
+
+        for (dist = 1; dist <= LZ_WINDOW && dist <= pos; dist++) {
+            size_t n = 0;
+            while (n < LZ_MAX_MATCH && pos + n < in->len &&
+                   in->data[pos + n] == in->data[pos + n - dist]) {
+                n++;
+            }
+            if (n > best_len) {
+                best_len = n;
+                best_dist = dist;
+            }
+        }
+
+        if (bit == 8) {
+            flag_at = out->len;
+            buf_put(out, 0);
+            bit = 0;
+        }
+        if (best_len >= LZ_MIN_MATCH) {
+            out->data[flag_at] |= (uint8_t)(1 << bit);
+            buf_put(out, (uint8_t)(best_dist - 1));
+            buf_put(out, (uint8_t)(best_len - LZ_MIN_MATCH));
+            pos += best_len;
+        } else {
+            buf_put(out, in->data[pos++]);
+        }
+        bit++;
+    }
+}
+
+static void write_blob(const char* path, const Buf* data, int compress) {
+    Buf lz = { 0 };
+
+    if (!compress) {
+        write_file(path, data->data, data->len);
+        return;
+    }
+    lz_compress(data, &lz);
+    write_file(path, lz.data, lz.len);
+    fprintf(stderr, "%s: %zu -> %zu bytes\n", path, data->len, lz.len);
+    free(lz.data);
+}
+
+// Text rather than a binary so both the ROM and the host build can pull
+// the masks in with #include (see gfx.c)
+static void write_masks(const char* path, const Image* img) {
+    FILE* f = fopen(path, "w");
+    uint32_t cx, x, y;
+
+    if (img->w % 16) die("mask image width must be a multiple of 16", path);
+    if (!f) die("cannot write", path);
+    fprintf(f, "// Generated by tools/gfxconv.c (-k), do not edit\n");
+    for (cx = 0; cx < img->w / 16; cx++) {
+        fprintf(f, "// Columns %u-%u\n", cx * 16, cx * 16 + 15);
+        for (y = 0; y < img->h; y++) {
+            uint16_t row = 0;
+            for (x = 0; x < 16; x++) {
+                if (img->idx[y * img->w + cx * 16 + x]) row |= (uint16_t)(0x8000 >> x);
+            }
+            fprintf(f, "0x%04X,%s", row, (y % 8 == 7) ? "\n" : " ");
+        }
+    }
+    fclose(f);
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: gfxconv [-b 2|4] [-d] [-l] [-k masks.inc] [-m map.out] "
+                    "[-p pal.out] [-t first_tile] [-P palette] in.png tiles.out\n");
+    exit(1);
+}
+
+int main(int argc, char** argv) {
+    const char* mask_path = NULL;
+    const char* map_path = NULL;
+    const char* pal_path = NULL;
+    int bits = 4, dedup = 0, compress = 0, first_tile = 0, palette = 0;
+    Image img;
+    Buf tiles = { 0 }, map = { 0 }, pal = { 0 };
+    uint8_t (*uniq)[64] = NULL;
+    uint32_t uniq_count = 0, tx, ty, i;
+    int argi;
+
+    for (argi = 1; argi < argc && argv[argi][0] == '-'; argi++) {
+        const char* opt = argv[argi];
+        if (strcmp(opt, "-d") == 0) dedup = 1;
+        else if (strcmp(opt, "-l") == 0) compress = 1;
+        else if (argi + 1 >= argc) usage();
+        else if (strcmp(opt, "-b") == 0) bits = atoi(argv[++argi]);
+        else if (strcmp(opt, "-k") == 0) mask_path = argv[++argi];
+        else if (strcmp(opt, "-m") == 0) map_path = argv[++argi];
+        else if (strcmp(opt, "-p") == 0) pal_path = argv[++argi];
+        else if (strcmp(opt, "-t") == 0) first_tile = (int)strtol(argv[++argi], NULL, 0);
+        else if (strcmp(opt, "-P") == 0) palette = atoi(argv[++argi]);
+        else usage();
+    }
+    if (argc - argi != 2 || (bits != 2 && bits != 4)) usage();
+
+    load_png(argv[argi], &img);
+    for (i = 0; i < img.w * img.h; i++) {
+        if (img.idx[i] >> bits) die("pixel index does not fit the bit depth", argv[argi]);
+    }
+
+    uniq = malloc((size_t)(img.w / 8) * (img.h / 8) * sizeof(*uniq));
+    for (ty = 0; ty < img.h / 8; ty++) {
+        for (tx = 0; tx < img.w / 8; tx++) {
+            uint8_t px[64], flipped[64];
+            uint16_t entry = 0;
+            uint32_t t = uniq_count;
+            int f;
+
+            get_tile(&img, tx, ty, 0, 0, px);
+
+            // f bit 0 = hflip, bit 1 = vflip
+            for (i = 0; dedup && i < uniq_count && t == uniq_count; i++) {
+                for (f = 0; f < 4; f++) {
+                    get_tile(&img, tx, ty, f & 1, f >> 1, flipped);
+                    if (memcmp(flipped, uniq[i], 64) == 0) {
+                        t = i;
+                        entry = (uint16_t)(((f & 1) ? MAP_HFLIP : 0) | ((f & 2) ? MAP_VFLIP : 0));
+                        break;
+                    }
+                }
+            }
+            if (t == uniq_count) {
+                memcpy(uniq[uniq_count++], px, 64);
+                put_tile(&tiles, px, bits);
+            }
+
+            entry |= (uint16_t)(((t + first_tile) & 0x3FF) | ((palette & 7) << 10));
+            buf_put(&map, (uint8_t)entry);
+            buf_put(&map, (uint8_t)(entry >> 8));
+        }
+    }
+    if (dedup) {
+        fprintf(stderr, "%s: %u of %u tiles unique\n", argv[argi], uniq_count,
+                (img.w / 8) * (img.h / 8));
+    }
+
+    write_blob(argv[argi + 1], &tiles, compress);
+    if (map_path) write_blob(map_path, &map, compress);
+    if (mask_path) write_masks(mask_path, &img);
+    if (pal_path) {
+        for (i = 0; i < (1u << bits); i++) {
+            uint16_t c = (i < img.pal_count) ? img.pal[i] : 0;
+            buf_put(&pal, (uint8_t)c);
+            buf_put(&pal, (uint8_t)(c >> 8));
+        }
+        write_file(pal_path, pal.data, pal.len);
+    }
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+# Native asset tools (see tools/gfxconv.c). Included by the top-level
+# Makefile for `make assets`; needs a C compiler and zlib, not PVSnesLib.
+
+TOOLS_CC ?= cc
+TOOLS_CFLAGS ?= -O2 -Wall
+GFXCONV := tools/gfxconv
+
+.PHONY: assets
+
+$(GFXCONV): tools/gfxconv.c
+	$(TOOLS_CC) $(TOOLS_CFLAGS) -o $@ $< -lz
+
+# Sprite tiles keep their VRAM layout (16x16 objects), so no dedup there
+assets: $(GFXCONV)
+	$(GFXCONV) -b 4 -l -k gfx/sprites.mask.inc gfx/sprites.png gfx/sprites.pic.lz
+	$(GFXCONV) -b 4 -l -p gfx/starfield.pal gfx/starfield.png gfx/starfield.pic.lz
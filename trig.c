@@ -0,0 +1,110 @@
+#include <snes.h>
+
+#include "hwmath.h"
+#include "trig.h"
+
+// sin(2*pi*a/256) * 256, rounded, for a in [0, 320). The extra 64 entries let
+// FX_COS() index a + 64 without wrapping.
+const s16 g_sinTable[320] = {
+    0, 6, 13, 19, 25, 31, 38, 44,
+    50, 56, 62, 68, 74, 80, 86, 92,
+    98, 104, 109, 115, 121, 126, 132, 137,
+    142, 147, 152, 157, 162, 167, 172, 177,
+    181, 185, 190, 194, 198, 202, 206, 209,
+    213, 216, 220, 223, 226, 229, 231, 234,
+    237, 239, 241, 243, 245, 247, 248, 250,
+    251, 252, 253, 254, 255, 255, 256, 256,
+    256, 256, 256, 255, 255, 254, 253, 252,
+    251, 250, 248, 247, 245, 243, 241, 239,
+    237, 234, 231, 229, 226, 223, 220, 216,
+    213, 209, 206, 202, 198, 194, 190, 185,
+    181, 177, 172, 167, 162, 157, 152, 147,
+    142, 137, 132, 126, 121, 115, 109, 104,
+    98, 92, 86, 80, 74, 68, 62, 56,
+    50, 44, 38, 31, 25, 19, 13, 6,
+    0, -6, -13, -19, -25, -31, -38, -44,
+    -50, -56, -62, -68, -74, -80, -86, -92,
+    -98, -104, -109, -115, -121, -126, -132, -137,
+    -142, -147, -152, -157, -162, -167, -172, -177,
+    -181, -185, -190, -194, -198, -202, -206, -209,
+    -213, -216, -220, -223, -226, -229, -231, -234,
+    -237, -239, -241, -243, -245, -247, -248, -250,
+    -251, -252, -253, -254, -255, -255, -256, -256,
+    -256, -256, -256, -255, -255, -254, -253, -252,
+    -251, -250, -248, -247, -245, -243, -241, -239,
+    -237, -234, -231, -229, -226, -223, -220, -216,
+    -213, -209, -206, -202, -198, -194, -190, -185,
+    -181, -177, -172, -167, -162, -157, -152, -147,
+    -142, -137, -132, -126, -121, -115, -109, -104,
+    -98, -92, -86, -80, -74, -68, -62, -56,
+    -50, -44, -38, -31, -25, -19, -13, -6,
+    0, 6, 13, 19, 25, 31, 38, 44,
+    50, 56, 62, 68, 74, 80, 86, 92,
+    98, 104, 109, 115, 121, 126, 132, 137,
+    142, 147, 152, 157, 162, 167, 172, 177,
+    181, 185, 190, 194, 198, 202, 206, 209,
+    213, 216, 220, 223, 226, 229, 231, 234,
+    237, 239, 241, 243, 245, 247, 248, 250,
+    251, 252, 253, 254, 255, 255, 256, 256,
+};
+
+// atan(small / large) in angle units (32 = 45 degrees), rounded, for
+// large in [16, 32) and small in [0, large]. Entries past the diagonal are 0.
+static const u8 s_atanOctant[16][32] = {
+    { 0, 3, 5, 8, 10, 12, 15, 17, 19, 21, 23, 25, 26, 28, 29, 31, 32, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },  // 16
+    { 0, 2, 5, 7, 9, 12, 14, 16, 18, 20, 22, 23, 25, 27, 28, 29, 31, 32, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },  // 17
+    { 0, 2, 5, 7, 9, 11, 13, 15, 17, 19, 21, 22, 24, 25, 27, 28, 30, 31, 32, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },  // 18
+    { 0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 21, 23, 24, 26, 27, 29, 30, 31, 32, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },  // 19
+    { 0, 2, 4, 6, 8, 10, 12, 14, 16, 17, 19, 20, 22, 23, 25, 26, 27, 29, 30, 31, 32, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },  // 20
+    { 0, 2, 4, 6, 8, 10, 11, 13, 15, 16, 18, 20, 21, 23, 24, 25, 27, 28, 29, 30, 31, 32, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },  // 21
+    { 0, 2, 4, 6, 7, 9, 11, 13, 14, 16, 17, 19, 20, 22, 23, 24, 26, 27, 28, 29, 30, 31, 32, 0, 0, 0, 0, 0, 0, 0, 0, 0 },  // 22
+    { 0, 2, 4, 5, 7, 9, 10, 12, 14, 15, 17, 18, 20, 21, 22, 24, 25, 26, 27, 28, 29, 30, 31, 32, 0, 0, 0, 0, 0, 0, 0, 0 },  // 23
+    { 0, 2, 3, 5, 7, 8, 10, 12, 13, 15, 16, 18, 19, 20, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 0, 0, 0, 0, 0, 0, 0 },  // 24
+    { 0, 2, 3, 5, 6, 8, 10, 11, 13, 14, 16, 17, 18, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 0, 0, 0, 0, 0, 0 },  // 25
+    { 0, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, 16, 18, 19, 20, 21, 22, 24, 25, 26, 27, 28, 29, 30, 30, 31, 32, 0, 0, 0, 0, 0 },  // 26
+    { 0, 2, 3, 5, 6, 7, 9, 10, 12, 13, 14, 16, 17, 18, 19, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 30, 31, 32, 0, 0, 0, 0 },  // 27
+    { 0, 1, 3, 4, 6, 7, 9, 10, 11, 13, 14, 15, 16, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 30, 31, 32, 0, 0, 0 },  // 28
+    { 0, 1, 3, 4, 6, 7, 8, 10, 11, 12, 14, 15, 16, 17, 18, 19, 21, 22, 23, 24, 25, 26, 26, 27, 28, 29, 30, 31, 31, 32, 0, 0 },  // 29
+    { 0, 1, 3, 4, 5, 7, 8, 9, 11, 12, 13, 14, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 27, 28, 29, 30, 31, 31, 32, 0 },  // 30
+    { 0, 1, 3, 4, 5, 7, 8, 9, 10, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 28, 29, 30, 31, 31, 32 },  // 31
+};
+
+u8 fx_atan2(s16 dx, s16 dy) {
+    u16 ax = (dx < 0) ? (u16)-dx : (u16)dx;
+    u16 ay = (dy < 0) ? (u16)-dy : (u16)dy;
+    u16 large, small;
+    u8 a;
+
+    if (ax >= ay) {
+        large = ax;
+        small = ay;
+    } else {
+        large = ay;
+        small = ax;
+    }
+    if (large == 0) return 0;
+
+    // Scale so the larger component lands in [16, 32)
+    while (large >= 32) {
+        large >>= 1;
+        small >>= 1;
+    }
+    while (large < 16) {
+        large <<= 1;
+        small <<= 1;
+    }
+
+    // Angle from the +x axis within the first quadrant
+    a = s_atanOctant[large - 16][small];
+    if (ay > ax) a = ANGLE_DOWN - a;
+
+    // Reflect into the right quadrant (screen Y points down)
+    if (dx < 0) a = ANGLE_LEFT - a;
+    if (dy < 0) a = (u8)(0 - a);
+    return a;
+}
+
+void fx_polar(u8 angle, s16 speed, s16* vx, s16* vy) {
+    *vx = fx_mul(FX_COS(angle), speed);
+    *vy = fx_mul(FX_SIN(angle), speed);
+}
@@ -0,0 +1,36 @@
+#ifndef STARSHMUP_TRIG_H
+#define STARSHMUP_TRIG_H
+
+#include <snes.h>
+
+// Angles are u8 (256 per turn) in screen space: 0 = right, 64 = down.
+#define ANGLE_RIGHT 0
+#define ANGLE_DOWN 64
+#define ANGLE_LEFT 128
+#define ANGLE_UP 192
+
+// 8.8 fixed point: 0x0100 == 1.0. Positions are whole pixels (s16) plus a
+// u8 sub-pixel byte; velocities are s16 8.8.
+#define FX_ONE 0x0100
+
+// Advance pixel position p with sub-pixel byte f by 8.8 velocity v
+#define FX_STEP(p, f, v)                                   \
+    do {                                                   \
+        u16 fx_t_ = (u16)(f) + ((u16)(v) & 0xFF);          \
+        (f) = (u8)fx_t_;                                   \
+        (p) += (s8)((u16)(v) >> 8) + (s16)(fx_t_ >> 8);    \
+    } while (0)
+
+// sin/cos in 8.8 (ROM table lookups)
+extern const s16 g_sinTable[320];
+#define FX_SIN(a) (g_sinTable[(u8)(a)])
+#define FX_COS(a) (g_sinTable[(u8)(a) + 64])
+
+// Angle of the vector (dx, dy) from octant reduction and a ROM table.
+// No trig or division; within 3 angle units of the exact angle.
+u8 fx_atan2(s16 dx, s16 dy);
+
+// 8.8 velocity of magnitude speed (8.8) along angle
+void fx_polar(u8 angle, s16 speed, s16* vx, s16* vy);
+
+#endif
@@ -0,0 +1,59 @@
+#include <snes.h>
+
+#include "ebullets.h"
+#include "enemies.h"
+#include "waves.h"
+
+#define BIOBOMB ENEMY_TYPE_BIOBOMB
+
+// Enemy spawn limits: SCREEN_W/H minus ENEMY_SIZE
+#define X_MAX 240
+#define Y_MAX 208
+
+// Main script. Keeps the level's population topped up one spawn per frame;
+// every half second from level 2 a random enemy fires (more patterns at
+// higher levels); every 4 seconds from level 3 adds a burst in the corners,
+// and from 50 kills also a row along the top edge.
+enum {
+    MAIN_TOP = W_SIZE_SPAWN_EDGE,
+    MAIN_FIRE = MAIN_TOP + 2 * W_SIZE_LOOP + W_SIZE_TOPUP + W_SIZE_WAIT + W_SIZE_NEXT,
+    MAIN_FIRE_NEXT = MAIN_FIRE + 3 * W_SIZE_IF + 3 * W_SIZE_FIRE,
+    MAIN_BURSTS = MAIN_FIRE_NEXT + W_SIZE_NEXT,
+};
+
+const u8 g_waveMain[] = {
+    W_SPAWN_EDGE(BIOBOMB),
+
+    // MAIN_TOP
+    W_LOOP(8),
+        W_LOOP(30),
+            W_TOPUP(BIOBOMB),
+            W_WAIT(1),
+        W_NEXT(),
+
+        // MAIN_FIRE
+        W_IF_LT(WVAR_LEVEL, 2, MAIN_FIRE_NEXT),
+        W_FIRE(EB_PAT_SPREAD),
+        W_IF_LT(WVAR_LEVEL, 4, MAIN_FIRE_NEXT),
+        W_FIRE(EB_PAT_BURST),
+        W_IF_LT(WVAR_LEVEL, 6, MAIN_FIRE_NEXT),
+        W_FIRE(EB_PAT_RING),
+
+    // MAIN_FIRE_NEXT
+    W_NEXT(),
+
+    // MAIN_BURSTS
+    W_IF_LT(WVAR_LEVEL, 3, MAIN_TOP),
+    W_SPAWN(BIOBOMB, 0, 0),
+    W_SPAWN(BIOBOMB, X_MAX, 0),
+    W_SPAWN(BIOBOMB, 0, Y_MAX),
+    W_SPAWN(BIOBOMB, X_MAX, Y_MAX),
+    W_IF_LT(WVAR_KILLS, 50, MAIN_TOP),
+    W_SPAWN(BIOBOMB, 16, 0),
+    W_SPAWN(BIOBOMB, 56, 0),
+    W_SPAWN(BIOBOMB, 96, 0),
+    W_SPAWN(BIOBOMB, 136, 0),
+    W_SPAWN(BIOBOMB, 176, 0),
+    W_SPAWN(BIOBOMB, 216, 0),
+    W_JUMP(MAIN_TOP),
+};
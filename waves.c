@@ -0,0 +1,136 @@
+#include <snes.h>
+
+#include "ebullets.h"
+#include "enemies.h"
+#include "game.h"
+#include "hwmath.h"
+#include "rng.h"
+#include "waves.h"
+
+// Live enemy population grows with level, capped by the table size
+#if BENCH_HAS(BENCH_ENEMIES)
+#define ENEMY_POP_FOR_LEVEL(l) MAX_ENEMIES
+#else
+#define ENEMY_POP_FOR_LEVEL(l) (((l) < MAX_ENEMIES) ? (l) : MAX_ENEMIES)
+#endif
+
+u8 g_waveOps;
+u8 g_waveOpsPeak;
+
+static const u8* s_script;  // NULL once the script has ended
+static u16 s_pc;            // Byte offset of the next instruction
+static u8 s_wait;           // Frames left to skip
+
+// LOOP/NEXT nesting: body start and iterations left, innermost last
+static u8 s_loopDepth;
+static u16 s_loopStart[WAVE_LOOP_DEPTH];
+static u8 s_loopLeft[WAVE_LOOP_DEPTH];
+
+static u16 read_u16(const u8* p) {
+    return p[0] | ((u16)p[1] << 8);
+}
+
+static u16 wave_var(u8 var) {
+    switch (var) {
+        case WVAR_KILLS: return g_game.kills;
+        case WVAR_LEVEL: return g_game.level;
+        default: return g_enemyCount;
+    }
+}
+
+void waves_start(const u8* script) {
+    s_script = script;
+    s_pc = 0;
+    s_wait = 0;
+    s_loopDepth = 0;
+}
+
+void waves_step(void) {
+    const u8* op;
+    u8 n = 0;
+    u8 run = 1;
+    u8 d;
+
+    if (s_wait) {
+        s_wait--;
+        run = 0;
+    }
+
+    while (run && s_script && n < WAVE_OPS_PER_FRAME) {
+        op = &s_script[s_pc];
+        n++;
+
+        switch (op[0]) {
+            case WOP_WAIT:
+                s_pc += W_SIZE_WAIT;
+                s_wait = op[1] ? op[1] - 1 : 0;
+                run = 0;
+                break;
+
+            case WOP_SPAWN:
+                enemies_spawn(op[1], op[2], op[3], g_game.level);
+                s_pc += W_SIZE_SPAWN;
+                break;
+
+            case WOP_SPAWN_EDGE:
+                enemies_spawn_edge(op[1], g_game.level);
+                s_pc += W_SIZE_SPAWN_EDGE;
+                break;
+
+            case WOP_TOPUP:
+                if (g_enemyCount < ENEMY_POP_FOR_LEVEL(g_game.level)) {
+                    enemies_spawn_edge(op[1], g_game.level);
+                }
+                s_pc += W_SIZE_TOPUP;
+                break;
+
+            // Nesting deeper than WAVE_LOOP_DEPTH, or a count of 0, is an
+            // authoring error
+            case WOP_LOOP:
+                s_pc += W_SIZE_LOOP;
+                s_loopStart[s_loopDepth] = s_pc;
+                s_loopLeft[s_loopDepth] = op[1];
+                s_loopDepth++;
+                break;
+
+            case WOP_NEXT:
+                d = s_loopDepth - 1;
+                if (--s_loopLeft[d]) {
+                    s_pc = s_loopStart[d];
+                } else {
+                    s_loopDepth = d;
+                    s_pc += W_SIZE_NEXT;
+                }
+                break;
+
+            case WOP_JUMP:
+                s_pc = read_u16(&op[1]);
+                break;
+
+            case WOP_IF_LT:
+            case WOP_IF_GE:
+                if ((wave_var(op[1]) < read_u16(&op[2])) == (op[0] == WOP_IF_LT)) {
+                    s_pc = read_u16(&op[4]);
+                } else {
+                    s_pc += W_SIZE_IF;
+                }
+                break;
+
+            case WOP_FIRE:
+                if (g_enemyCount) {
+                    d = hw_range(rng_next_u16(), g_enemyCount);
+                    ebullets_fire(op[1], g_enemyX[d] + (ENEMY_SIZE / 2) - (EBULLET_SIZE / 2),
+                                  g_enemyY[d] + (ENEMY_SIZE / 2) - (EBULLET_SIZE / 2));
+                }
+                s_pc += W_SIZE_FIRE;
+                break;
+
+            default:  // WOP_END
+                s_script = 0;
+                break;
+        }
+    }
+
+    g_waveOps = n;
+    if (n > g_waveOpsPeak) g_waveOpsPeak = n;
+}
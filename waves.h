@@ -0,0 +1,75 @@
+#ifndef STARSHMUP_WAVES_H
+#define STARSHMUP_WAVES_H
+
+#include <snes.h>
+
+// Wave scripts: byte code in ROM, run by waves_step() once per frame.
+//
+// An instruction is an opcode byte and its operands; 16-bit operands and
+// jump targets (byte offsets into the script) are little-endian. A frame
+// runs instructions until a WAIT, END or WAVE_OPS_PER_FRAME of them,
+// whichever comes first, and resumes from there the next frame. A burst of
+// spawns therefore spreads over several frames instead of spiking one.
+#define WAVE_OPS_PER_FRAME 8
+#define WAVE_LOOP_DEPTH 2
+
+enum {
+    WOP_END,         // Stop the script
+    WOP_WAIT,        // frames (u8): resume after this many frames
+    WOP_SPAWN,       // type, x, y (u8 pixels)
+    WOP_SPAWN_EDGE,  // type: at a random screen edge
+    WOP_TOPUP,       // type: one edge spawn if below the level's population
+    WOP_LOOP,        // count (u8): run the body up to the matching NEXT count times
+    WOP_NEXT,
+    WOP_JUMP,        // target (u16)
+    WOP_IF_LT,       // var, value (u16), target (u16): jump if var < value
+    WOP_IF_GE,       // var, value (u16), target (u16): jump if var >= value
+    WOP_FIRE,        // pattern: a random live enemy starts an EB_PAT_* pattern
+    WOP_COUNT
+};
+
+// Variables for WOP_IF_LT / WOP_IF_GE
+enum {
+    WVAR_KILLS,  // Kills this game
+    WVAR_LEVEL,
+    WVAR_ALIVE,  // Live enemies
+};
+
+// Authoring helpers; W_SIZE_* give instruction sizes for computing labels
+#define W_LO(v) (u8)((v) & 0xFF)
+#define W_HI(v) (u8)(((v) >> 8) & 0xFF)
+
+#define W_END() WOP_END
+#define W_WAIT(n) WOP_WAIT, (n)
+#define W_SPAWN(type, x, y) WOP_SPAWN, (type), (x), (y)
+#define W_SPAWN_EDGE(type) WOP_SPAWN_EDGE, (type)
+#define W_TOPUP(type) WOP_TOPUP, (type)
+#define W_LOOP(n) WOP_LOOP, (n)
+#define W_NEXT() WOP_NEXT
+#define W_JUMP(to) WOP_JUMP, W_LO(to), W_HI(to)
+#define W_IF_LT(var, v, to) WOP_IF_LT, (var), W_LO(v), W_HI(v), W_LO(to), W_HI(to)
+#define W_IF_GE(var, v, to) WOP_IF_GE, (var), W_LO(v), W_HI(v), W_LO(to), W_HI(to)
+#define W_FIRE(pattern) WOP_FIRE, (pattern)
+
+#define W_SIZE_END 1
+#define W_SIZE_WAIT 2
+#define W_SIZE_SPAWN 4
+#define W_SIZE_SPAWN_EDGE 2
+#define W_SIZE_TOPUP 2
+#define W_SIZE_LOOP 2
+#define W_SIZE_NEXT 1
+#define W_SIZE_JUMP 3
+#define W_SIZE_IF 6
+#define W_SIZE_FIRE 2
+
+// Scripts (wave_scripts.c)
+extern const u8 g_waveMain[];
+
+// Instructions run by the last waves_step(), and the most in any frame
+extern u8 g_waveOps;
+extern u8 g_waveOpsPeak;
+
+void waves_start(const u8* script);
+void waves_step(void);
+
+#endif
@@ -0,0 +1,117 @@
+#include <snes.h>
+#include <string.h>
+
+#include "xfer.h"
+
+typedef struct XferEntry {
+    const u8* src;
+    u16 dest;
+    u16 size;
+    u8 kind;
+    u8 prio;
+} XferEntry;
+
+u16 g_xferBytes = 0;
+u8 g_xferPending = 0;
+
+// Sorted by descending priority, FIFO within a priority
+static XferEntry s_queue[XFER_MAX];
+static u8 s_count = 0;
+
+static u16 s_bg2ScrollY = 0;
+
+void xfer_init(void) {
+    s_count = 0;
+    g_xferPending = 0;
+    g_xferBytes = 0;
+}
+
+u8 xfer_queue(u8 kind, const u8* src, u16 dest, u16 size, u8 prio) {
+    XferEntry* e;
+    u8 i, at;
+
+    for (i = 0; i < s_count; i++) {
+        e = &s_queue[i];
+        if (e->src == src && e->dest == dest && e->size == size && e->kind == kind) return 1;
+    }
+    if (s_count >= XFER_MAX) return 0;
+
+    at = s_count;
+    while (at > 0 && s_queue[at - 1].prio < prio) {
+        s_queue[at] = s_queue[at - 1];
+        at--;
+    }
+
+    e = &s_queue[at];
+    e->src = src;
+    e->dest = dest;
+    e->size = size;
+    e->kind = kind;
+    e->prio = prio;
+    s_count++;
+    g_xferPending = s_count;
+    return 1;
+}
+
+void xfer_set_bg2_vscroll(u16 y) {
+    s_bg2ScrollY = y;
+}
+
+static void send(u8 kind, const u8* src, u16 dest, u16 size) {
+    if (kind == XFER_CGRAM) {
+        dmaCopyCGram((u8*)src, dest, size);
+    } else {
+        dmaCopyVram((u8*)src, dest, size);
+    }
+}
+
+// Sends queued transfers until 'budget' bytes are used; returns bytes sent
+static u16 run(u16 budget) {
+    XferEntry* e;
+    u16 used = 0;
+    u16 chunk;
+    u8 done = 0;
+
+    while (done < s_count) {
+        e = &s_queue[done];
+        chunk = budget - used;
+        if (chunk == 0) break;
+
+        if (e->size <= chunk) {
+            send(e->kind, e->src, e->dest, e->size);
+            used += e->size;
+            done++;
+            continue;
+        }
+
+        // Send a word-aligned head; the rest stays queued at the front
+        chunk &= ~1u;
+        if (chunk == 0) break;
+        send(e->kind, e->src, e->dest, chunk);
+        e->src += chunk;
+        e->dest += chunk >> 1;  // VRAM words and CGRAM colors are both 2 bytes
+        e->size -= chunk;
+        used += chunk;
+        break;
+    }
+
+    if (done) {
+        s_count -= done;
+        memmove(s_queue, &s_queue[done], s_count * sizeof(XferEntry));
+    }
+    g_xferPending = s_count;
+    return used;
+}
+
+void xfer_vblank(void) {
+    REG_BG2VOFS = s_bg2ScrollY & 0xFF;
+    REG_BG2VOFS = (s_bg2ScrollY >> 8) & 0xFF;
+
+    g_xferBytes = run(XFER_BUDGET_BYTES);
+}
+
+void xfer_flush_all(void) {
+    while (s_count) {
+        run(0xFFFE);
+    }
+}
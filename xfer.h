@@ -0,0 +1,46 @@
+#ifndef STARSHMUP_XFER_H
+#define STARSHMUP_XFER_H
+
+#include <snes.h>
+
+// VBlank transfer queue for VRAM (tiles and tilemaps) and CGRAM.
+//
+// Gameplay code queues transfers at any time; xfer_vblank(), called right
+// after WaitForVBlank(), plays them back highest priority first until the
+// per-frame byte budget is spent. Whatever does not fit, including the tail
+// of a partly sent transfer, carries over to the next frame. Source buffers
+// are read at transfer time and must stay valid until then.
+#define XFER_MAX 16
+#define XFER_BUDGET_BYTES 4096  // Leaves headroom for the 544-byte OAM copy
+
+typedef enum {
+    XFER_VRAM,   // dest = VRAM word address
+    XFER_CGRAM,  // dest = CGRAM color index
+} XferKind;
+
+// Higher runs first; equal priorities run in queue order
+#define XFER_PRIO_LOW 0
+#define XFER_PRIO_NORMAL 1
+#define XFER_PRIO_HIGH 2
+
+// Bytes transferred by the last xfer_vblank(), and transfers still queued
+extern u16 g_xferBytes;
+extern u8 g_xferPending;
+
+void xfer_init(void);
+
+// Queue a transfer. A transfer identical to one still pending is merged with
+// it. Returns 0 if the queue is full.
+u8 xfer_queue(u8 kind, const u8* src, u16 dest, u16 size, u8 prio);
+
+// BG2 vertical scroll, latched and written by xfer_vblank(). Horizontal
+// scroll comes from the parallax HDMA tables (parallax.h).
+void xfer_set_bg2_vscroll(u16 y);
+
+// Play back queued transfers within the byte budget (call during VBlank)
+void xfer_vblank(void);
+
+// Play back everything regardless of budget (forced blank only)
+void xfer_flush_all(void);
+
+#endif